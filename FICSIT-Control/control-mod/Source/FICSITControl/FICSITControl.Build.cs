@@ -1,3 +1,4 @@
+using System.IO;
 using UnrealBuildTool;
 
 public class FICSITControl : ModuleRules
@@ -29,5 +30,11 @@ public class FICSITControl : ModuleRules
             "Networking",
             "Sockets"
         });
+
+        // FSocketBSD, whose native descriptors the socket reactor polls
+        PrivateIncludePaths.Add(Path.Combine(EngineDirectory, "Source", "Runtime", "Sockets", "Private"));
+
+        // permessage-deflate for WebSocket streams
+        AddEngineThirdPartyPrivateStaticDependencies(Target, "zlib");
     }
 }
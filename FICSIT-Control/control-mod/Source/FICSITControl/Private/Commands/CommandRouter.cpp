@@ -1,8 +1,22 @@
 #include "CommandRouter.h"
 #include "Misc/Guid.h"
+#include "Async/Async.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogCommandRouter, Log, All);
 
+/** Compact UTF-8 bytes of serialized JSON, as retained commands keep it */
+static TArray<uint8> ToUtf8Bytes(const FString& Text)
+{
+    const FTCHARToUTF8 Utf8(*Text);
+    return TArray<uint8>(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+}
+
+static FString FromUtf8Bytes(const TArray<uint8>& Bytes)
+{
+    const FUTF8ToTCHAR Text(reinterpret_cast<const ANSICHAR*>(Bytes.GetData()), Bytes.Num());
+    return FString(Text.Length(), Text.Get());
+}
+
 FCommandRouter::FCommandRouter()
 {
 }
@@ -19,79 +33,422 @@ void FCommandRouter::RegisterExecutor(TSharedRef<ICommandExecutor> Executor)
 }
 
 FControlCommand FCommandRouter::SubmitCommand(const FString& IdempotencyKey,
-    const FString& Type, TSharedPtr<FJsonObject> Payload)
+    const FString& Type, TSharedPtr<FJsonObject> Payload, const FString& Issuer)
 {
-    FScopeLock Lock(&Mutex);
+    FControlCommandRequest Request;
+    Request.IdempotencyKey = IdempotencyKey;
+    Request.Type = Type;
+    Request.Payload = Payload;
+    Request.Issuer = Issuer;
+    return SubmitCommand(Request);
+}
+
+FControlCommand FCommandRouter::SubmitCommand(const FControlCommandRequest& Request)
+{
+    const FString& IdempotencyKey = Request.IdempotencyKey;
+    const FString& Type = Request.Type;
 
-    // Idempotency check
-    if (const FString* ExistingId = IdempotencyIndex.Find(IdempotencyKey))
+    TSharedPtr<FControlCommand> Created;
+    TSharedPtr<ICommandExecutor> Executor;
     {
-        if (TSharedRef<FControlCommand>* ExistingCmd = Commands.Find(*ExistingId))
+        FScopeLock Lock(&AdmissionMutex);
+
+        // Idempotency check
+        if (const FString* ExistingId = IdempotencyIndex.Find(IdempotencyKey))
         {
-            UE_LOG(LogCommandRouter, Verbose, TEXT("Idempotency hit for key %s -> %s"),
-                *IdempotencyKey, **ExistingId);
-            return **ExistingCmd;
+            FControlCommand Existing;
+            if (FindCommand(*ExistingId, Existing))
+            {
+                UE_LOG(LogCommandRouter, Verbose, TEXT("Idempotency hit for key %s -> %s"),
+                    *IdempotencyKey, **ExistingId);
+                return Existing;
+            }
         }
+
+        // Rate limit check
+        if (!CheckRateLimit())
+        {
+            FControlCommand RateLimited;
+            RateLimited.CommandId = TEXT("");
+            RateLimited.Status = EControlCommandStatus::Failed;
+            RateLimited.Error = TEXT("Rate limit exceeded");
+            RateLimited.Rejection = EControlRejection::RateLimited;
+            return RateLimited;
+        }
+
+        // Game-thread queue check
+        if (PendingCommands.Load() >= MaxPendingCommands)
+        {
+            FControlCommand Overloaded;
+            Overloaded.Status = EControlCommandStatus::Failed;
+            Overloaded.Error = TEXT("Server busy");
+            Overloaded.Rejection = EControlRejection::Overloaded;
+            return Overloaded;
+        }
+
+        // Validate command type
+        const TSharedRef<ICommandExecutor>* Found = Executors.Find(Type);
+        if (!Found)
+        {
+            FControlCommand Unknown;
+            Unknown.CommandId = TEXT("");
+            Unknown.Status = EControlCommandStatus::Failed;
+            Unknown.Error = FString::Printf(TEXT("Unknown command type: %s"), *Type);
+            return Unknown;
+        }
+
+        // Create command
+        Executor = *Found;
+        Created = CreateCommand(Request);
+        RecentCommandTimes.Add(FPlatformTime::Seconds());
     }
+    TSharedRef<FControlCommand> Command = Created.ToSharedRef();
 
-    // Rate limit check
-    if (!CheckRateLimit())
+    // Broadcast QUEUED status; this and everything after runs without the admission lock
+    OnStatusChanged.Broadcast(*Command);
+
+    // Validate the payload here so only game-state work reaches the game thread
+    FString ValidationError;
+    if (!Executor->Validate(*Command, ValidationError))
     {
-        FControlCommand RateLimited;
-        RateLimited.CommandId = TEXT("");
-        RateLimited.Status = EControlCommandStatus::Failed;
-        RateLimited.Error = TEXT("Rate limit exceeded");
-        return RateLimited;
+        --PendingCommands;
+        UpdateStatus(Command, EControlCommandStatus::Failed, ValidationError);
+        return *Command;
     }
 
-    // Validate command type
-    TSharedRef<ICommandExecutor>* Executor = Executors.Find(Type);
-    if (!Executor)
+    // Copied before dispatch: from then on the game thread may be updating it
+    FControlCommand Queued = *Command;
+
+    TArray<FPendingCommand> Pending;
+    Pending.Add({ Command, Executor });
+    DispatchToGameThread(MoveTemp(Pending), false);
+
+    return Queued;
+}
+
+TArray<FControlCommand> FCommandRouter::SubmitBatch(const TArray<FControlCommandRequest>& Requests)
+{
+    TArray<FControlCommand> Results;
+    Results.Reserve(Requests.Num());
+
+    TArray<FPendingCommand> Pending;
+    Pending.Reserve(Requests.Num());
+
+    // Where each new command's result goes, filled in once it is validated
+    TArray<int32> ResultSlots;
+    ResultSlots.Reserve(Requests.Num());
     {
-        FControlCommand Unknown;
-        Unknown.CommandId = TEXT("");
-        Unknown.Status = EControlCommandStatus::Failed;
-        Unknown.Error = FString::Printf(TEXT("Unknown command type: %s"), *Type);
-        return Unknown;
-    }
+        FScopeLock Lock(&AdmissionMutex);
 
-    // Create command
-    auto Command = MakeShared<FControlCommand>();
-    Command->CommandId = GenerateCommandId();
-    Command->IdempotencyKey = IdempotencyKey;
-    Command->Type = Type;
-    Command->Payload = Payload;
-    Command->Status = EControlCommandStatus::Queued;
+        // A batch is one submission to the interactive limiter, while each of
+        // its commands is charged to the batch budget; bulk work may only
+        // take half of the game-thread queue
+        const bool bRateLimited = !CheckRateLimit() || !CheckBatchRateLimit(Requests.Num());
+        if (bRateLimited || PendingCommands.Load() + Requests.Num() > MaxPendingCommands / 2)
+        {
+            for (int32 i = 0; i < Requests.Num(); ++i)
+            {
+                FControlCommand& Rejected = Results.AddDefaulted_GetRef();
+                Rejected.Status = EControlCommandStatus::Failed;
+                Rejected.Error = bRateLimited ? TEXT("Rate limit exceeded") : TEXT("Server busy");
+                Rejected.Rejection = bRateLimited ? EControlRejection::RateLimited : EControlRejection::Overloaded;
+            }
+            return Results;
+        }
+        const double Now = FPlatformTime::Seconds();
+        RecentCommandTimes.Add(Now);
+        RecentBatches.Emplace(Now, Requests.Num());
 
-    Commands.Add(Command->CommandId, Command);
-    IdempotencyIndex.Add(IdempotencyKey, Command->CommandId);
-    RecentCommandTimes.Add(FPlatformTime::Seconds());
+        for (const FControlCommandRequest& Request : Requests)
+        {
+            // Idempotency check
+            if (const FString* ExistingId = IdempotencyIndex.Find(Request.IdempotencyKey))
+            {
+                FControlCommand Existing;
+                if (FindCommand(*ExistingId, Existing))
+                {
+                    Results.Add(MoveTemp(Existing));
+                    continue;
+                }
+            }
 
-    UE_LOG(LogCommandRouter, Log, TEXT("Command %s queued: type=%s"), *Command->CommandId, *Type);
+            const TSharedRef<ICommandExecutor>* Executor = Executors.Find(Request.Type);
+            if (!Executor)
+            {
+                FControlCommand& Unknown = Results.AddDefaulted_GetRef();
+                Unknown.Status = EControlCommandStatus::Failed;
+                Unknown.Error = FString::Printf(TEXT("Unknown command type: %s"), *Request.Type);
+                continue;
+            }
 
-    // Broadcast QUEUED status
-    OnStatusChanged.Broadcast(*Command);
+            Pending.Add({ CreateCommand(Request), TSharedPtr<ICommandExecutor>(*Executor) });
+            ResultSlots.Add(Results.AddDefaulted());
+        }
+    }
 
-    // Execute asynchronously — executor is responsible for game thread scheduling
-    TSharedRef<ICommandExecutor> ExecRef = *Executor;
-    TSharedRef<FControlCommand> CmdRef = Command;
-    UWorld* CapturedWorld = World;
-    FCommandRouter* Self = this;
+    // Validation only reads the payload; it needs no lock
+    for (int32 i = 0; i < Pending.Num(); ++i)
+    {
+        FPendingCommand& Item = Pending[i];
+        FString ValidationError;
+        if (!Item.Executor->Validate(*Item.Command, ValidationError))
+        {
+            StoreOutcome(Item.Command, EControlCommandStatus::Failed, ValidationError);
+            Item.Executor.Reset();
+            --PendingCommands;
+        }
+        Results[ResultSlots[i]] = *Item.Command;
+    }
 
-    // Mark as RUNNING
-    UpdateStatus(CmdRef, EControlCommandStatus::Running);
+    UE_LOG(LogCommandRouter, Log, TEXT("Batch of %d commands queued (%d new)"), Requests.Num(), Pending.Num());
 
-    // Dispatch to executor
-    ExecRef->Execute(CmdRef, CapturedWorld);
+    if (Pending.Num() > 0)
+    {
+        DispatchToGameThread(MoveTemp(Pending), true);
+    }
 
-    return *Command;
+    return Results;
 }
 
 TSharedPtr<FControlCommand> FCommandRouter::GetCommand(const FString& CommandId) const
 {
-    FScopeLock Lock(&Mutex);
-    const TSharedRef<FControlCommand>* Found = Commands.Find(CommandId);
-    return Found ? TSharedPtr<FControlCommand>(*Found) : nullptr;
+    // Only this command's shard is locked; polls of other commands proceed alongside
+    FRetainedCommand Retained;
+    {
+        const FCommandShard& Shard = GetShard(CommandId);
+        FScopeLock Lock(&Shard.Mutex);
+        // A copy, taken under the lock every status change is made under
+        if (const TSharedRef<FControlCommand>* Live = Shard.Live.Find(CommandId))
+        {
+            return MakeShared<FControlCommand>(**Live);
+        }
+        const FRetainedCommand* Found = Shard.Retained.Find(CommandId);
+        if (!Found || IsExpired(*Found, FPlatformTime::Seconds())) return nullptr;
+        Retained = *Found;
+    }
+
+    // Parsed after the shard lock is released
+    return MakeShared<FControlCommand>(ExpandCommand(CommandId, Retained));
+}
+
+TSharedRef<FJsonObject> FCommandRouter::GetStatsJson() const
+{
+    int32 NumLive = 0;
+    int32 NumRetained = 0;
+    for (const FCommandShard& Shard : Shards)
+    {
+        FScopeLock Lock(&Shard.Mutex);
+        NumLive += Shard.Live.Num();
+        NumRetained += Shard.Retained.Num();
+    }
+
+    auto Stats = MakeShared<FJsonObject>();
+    Stats->SetNumberField(TEXT("live"), NumLive);
+    Stats->SetNumberField(TEXT("retained"), NumRetained);
+    Stats->SetNumberField(TEXT("retainedBytes"), static_cast<double>(RetainedBytes.Load()));
+    Stats->SetNumberField(TEXT("evicted"), static_cast<double>(EvictedCommands.Load()));
+    Stats->SetNumberField(TEXT("shards"), NumShards);
+    Stats->SetNumberField(TEXT("retentionSeconds"), RetentionSeconds);
+    Stats->SetNumberField(TEXT("maxRetained"), MaxRetainedCommands);
+    return Stats;
+}
+
+bool FCommandRouter::WaitForCompletion(const FString& CommandId,
+    TFunction<void(const FControlCommand&)> OnSettled)
+{
+    {
+        FCommandShard& Shard = GetShard(CommandId);
+        FScopeLock Lock(&Shard.Mutex);
+        const TSharedRef<FControlCommand>* Live = Shard.Live.Find(CommandId);
+
+        // Checked under the shard lock NotifyWaiters takes, so a settle cannot slip between
+        if (Live && !IsTerminalStatus((*Live)->Status))
+        {
+            Shard.Waiters.FindOrAdd(CommandId).Add(MoveTemp(OnSettled));
+            return true;
+        }
+    }
+
+    FControlCommand Settled;
+    if (!FindCommand(CommandId, Settled)) return false;
+
+    OnSettled(Settled);
+    return true;
+}
+
+void FCommandRouter::NotifyWaiters(const TSharedRef<FControlCommand>& Command)
+{
+    // Serialized before taking the shard lock, which pollers of the shard share
+    FRetainedCommand Compact = CompactCommand(*Command);
+
+    TArray<TFunction<void(const FControlCommand&)>> Settled;
+    {
+        FCommandShard& Shard = GetShard(Command->CommandId);
+        FScopeLock Lock(&Shard.Mutex);
+        Shard.Waiters.RemoveAndCopyValue(Command->CommandId, Settled);
+        RetireCommand(Command->CommandId, MoveTemp(Compact));
+    }
+
+    for (const TFunction<void(const FControlCommand&)>& OnSettled : Settled)
+    {
+        OnSettled(*Command);
+    }
+}
+
+bool FCommandRouter::FindCommand(const FString& CommandId, FControlCommand& OutCommand) const
+{
+    FRetainedCommand Retained;
+    {
+        const FCommandShard& Shard = GetShard(CommandId);
+        FScopeLock Lock(&Shard.Mutex);
+        if (const TSharedRef<FControlCommand>* Live = Shard.Live.Find(CommandId))
+        {
+            OutCommand = **Live;
+            return true;
+        }
+        const FRetainedCommand* Found = Shard.Retained.Find(CommandId);
+        if (!Found || IsExpired(*Found, FPlatformTime::Seconds())) return false;
+        Retained = *Found;
+    }
+
+    OutCommand = ExpandCommand(CommandId, Retained);
+    return true;
+}
+
+bool FCommandRouter::IsExpired(const FRetainedCommand& Retained, double Now) const
+{
+    // Pruning only runs on submission, so an idle server relies on this check
+    return RetentionSeconds > 0.0f && Retained.CreatedTime < Now - RetentionSeconds;
+}
+
+void FCommandRouter::RetireCommand(const FString& CommandId, FRetainedCommand&& Compact)
+{
+    FCommandShard& Shard = GetShard(CommandId);
+    if (!Shard.Live.Contains(CommandId)) return;
+
+    RetainedBytes += Compact.Payload.Num() + Compact.Result.Num();
+    Shard.Retained.Add(CommandId, MoveTemp(Compact));
+    Shard.Live.Remove(CommandId);
+}
+
+FCommandRouter::FRetainedCommand FCommandRouter::CompactCommand(const FControlCommand& Command)
+{
+    // Only what lookups and replays answer with survives; routing fields are done with
+    FRetainedCommand Retained;
+    Retained.IdempotencyKey = Command.IdempotencyKey;
+    Retained.RequestId = Command.RequestId;
+    Retained.Error = Command.Error;
+    Retained.Type = FName(*Command.Type);
+    Retained.Status = Command.Status;
+    Retained.CreatedTime = Command.CreatedTime;
+    if (Command.Payload.IsValid())
+    {
+        Retained.Payload = ToUtf8Bytes(JsonToString(Command.Payload.ToSharedRef()));
+    }
+    if (Command.Result.IsValid())
+    {
+        // Any JSON value is kept as a one-element array, the form the serializer takes
+        FString Text;
+        auto Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Text);
+        FJsonSerializer::Serialize(TArray<TSharedPtr<FJsonValue>>{ Command.Result }, Writer);
+        Retained.Result = ToUtf8Bytes(Text);
+    }
+    return Retained;
+}
+
+void FCommandRouter::PruneRetained(double Now)
+{
+    const double Cutoff = RetentionSeconds > 0.0f ? Now - RetentionSeconds : -DBL_MAX;
+
+    // Commands still running at the front, kept in creation order
+    TArray<FCommandAge> StillLive;
+    int32 NumKept = CommandOrder.Num() - OrderHead;
+
+    while (OrderHead < CommandOrder.Num())
+    {
+        const FCommandAge& Oldest = CommandOrder[OrderHead];
+        if (NumKept <= MaxRetainedCommands && Oldest.CreatedTime >= Cutoff)
+        {
+            break;
+        }
+
+        // A command that has not settled is never dropped, but does not hold up newer ones
+        FRetainedCommand Retained;
+        bool bRetained = false;
+        bool bLive = false;
+        {
+            FCommandShard& Shard = GetShard(Oldest.CommandId);
+            FScopeLock ShardLock(&Shard.Mutex);
+            bRetained = Shard.Retained.RemoveAndCopyValue(Oldest.CommandId, Retained);
+            bLive = !bRetained && Shard.Live.Contains(Oldest.CommandId);
+        }
+        if (!bRetained)
+        {
+            if (bLive)
+            {
+                StillLive.Add(Oldest);
+            }
+            else
+            {
+                --NumKept;
+            }
+            ++OrderHead;
+            continue;
+        }
+
+        // The key may have been reused by a newer command
+        const FString* Indexed = IdempotencyIndex.Find(Retained.IdempotencyKey);
+        if (Indexed && *Indexed == Oldest.CommandId)
+        {
+            IdempotencyIndex.Remove(Retained.IdempotencyKey);
+        }
+
+        RetainedBytes -= Retained.Payload.Num() + Retained.Result.Num();
+        ++EvictedCommands;
+        ++OrderHead;
+        --NumKept;
+    }
+
+    // Put the skipped commands back in the slots just vacated, oldest first
+    OrderHead -= StillLive.Num();
+    for (int32 i = 0; i < StillLive.Num(); ++i)
+    {
+        CommandOrder[OrderHead + i] = MoveTemp(StillLive[i]);
+    }
+
+    // Shift the survivors down once the dropped prefix is the larger part
+    if (OrderHead > 0 && OrderHead * 2 >= CommandOrder.Num())
+    {
+        CommandOrder.RemoveAt(0, OrderHead, false);
+        OrderHead = 0;
+    }
+}
+
+FControlCommand FCommandRouter::ExpandCommand(const FString& CommandId, const FRetainedCommand& Retained)
+{
+    FControlCommand Command;
+    Command.CommandId = CommandId;
+    Command.IdempotencyKey = Retained.IdempotencyKey;
+    Command.Type = Retained.Type.ToString();
+    Command.RequestId = Retained.RequestId;
+    Command.Status = Retained.Status;
+    Command.CreatedTime = Retained.CreatedTime;
+    Command.Error = Retained.Error;
+
+    if (Retained.Payload.Num() > 0)
+    {
+        FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(FromUtf8Bytes(Retained.Payload)), Command.Payload);
+    }
+    if (Retained.Result.Num() > 0)
+    {
+        TArray<TSharedPtr<FJsonValue>> Values;
+        if (FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(FromUtf8Bytes(Retained.Result)), Values)
+            && Values.Num() == 1)
+        {
+            Command.Result = Values[0];
+        }
+    }
+    return Command;
 }
 
 FString FCommandRouter::GenerateCommandId() const
@@ -110,17 +467,152 @@ bool FCommandRouter::CheckRateLimit()
     return RecentCommandTimes.Num() < RateLimit;
 }
 
-void FCommandRouter::UpdateStatus(TSharedRef<FControlCommand> Command,
-    EControlCommandStatus NewStatus, const FString& Error)
+bool FCommandRouter::CheckBatchRateLimit(int32 NumCommands)
 {
+    const double WindowStart = FPlatformTime::Seconds() - 1.0;
+    RecentBatches.RemoveAll([WindowStart](const TPair<double, int32>& Batch) { return Batch.Key < WindowStart; });
+
+    int32 Used = 0;
+    for (const TPair<double, int32>& Batch : RecentBatches)
+    {
+        Used += Batch.Value;
+    }
+    return Used + NumCommands <= BatchRateLimit;
+}
+
+TSharedRef<FControlCommand> FCommandRouter::CreateCommand(const FControlCommandRequest& Request)
+{
+    auto Command = MakeShared<FControlCommand>();
+    Command->CommandId = GenerateCommandId();
+    Command->IdempotencyKey = Request.IdempotencyKey;
+    Command->Type = Request.Type;
+    Command->Payload = Request.Payload;
+    Command->Issuer = Request.Issuer;
+    Command->RequestId = Request.RequestId;
+    Command->StreamId = Request.StreamId;
+    Command->Status = EControlCommandStatus::Queued;
+    const double Now = FPlatformTime::Seconds();
+    Command->CreatedTime = Now;
+
+    {
+        FCommandShard& Shard = GetShard(Command->CommandId);
+        FScopeLock ShardLock(&Shard.Mutex);
+        Shard.Live.Add(Command->CommandId, Command);
+    }
+
+    CommandOrder.Add({ Command->CommandId, Now });
+    IdempotencyIndex.Add(Request.IdempotencyKey, Command->CommandId);
+    PruneRetained(Now);
+
+    // Counted now, so concurrent submitters see the queue as it will be
+    ++PendingCommands;
+
+    UE_LOG(LogCommandRouter, Log, TEXT("Command %s queued: type=%s"), *Command->CommandId, *Request.Type);
+    return Command;
+}
+
+void FCommandRouter::DispatchToGameThread(TArray<FPendingCommand>&& Pending, bool bBatch)
+{
+    TWeakPtr<FCommandRouter> WeakSelf = AsShared();
+    UWorld* CapturedWorld = World;
+
+    int32 NumToApply = 0;
+    for (const FPendingCommand& Item : Pending)
+    {
+        NumToApply += Item.Executor.IsValid() ? 1 : 0;
+    }
+
+    AsyncTask(ENamedThreads::GameThread, [WeakSelf, CapturedWorld, Pending = MoveTemp(Pending), bBatch, NumToApply]()
+    {
+        TSharedPtr<FCommandRouter> Self = WeakSelf.Pin();
+        if (!Self.IsValid()) return;
+
+        TArray<FControlCommand> Completed;
+        if (bBatch)
+        {
+            Completed.Reserve(Pending.Num());
+        }
+
+        for (const FPendingCommand& Item : Pending)
+        {
+            if (Item.Executor.IsValid())
+            {
+                // Batches skip the per-command RUNNING event; they report once at the end
+                if (bBatch)
+                {
+                    Self->StoreOutcome(Item.Command, EControlCommandStatus::Running);
+                }
+                else
+                {
+                    Self->UpdateStatus(Item.Command, EControlCommandStatus::Running);
+                }
+
+                // Executors fill in a private copy; lookups may be reading the published one
+                TSharedRef<FControlCommand> Working = MakeShared<FControlCommand>(*Item.Command);
+                if (CapturedWorld)
+                {
+                    Item.Executor->Apply(Working, CapturedWorld);
+                }
+                else
+                {
+                    Working->Status = EControlCommandStatus::Failed;
+                    Working->Error = TEXT("World not available");
+                }
+
+                if (bBatch)
+                {
+                    Self->StoreOutcome(Item.Command, Working->Status, Working->Error, Working->Result);
+                }
+                else
+                {
+                    Self->UpdateStatus(Item.Command, Working->Status, Working->Error, Working->Result);
+                }
+            }
+
+            if (bBatch)
+            {
+                Completed.Add(*Item.Command);
+                Self->NotifyWaiters(Item.Command);
+            }
+        }
+
+        Self->PendingCommands -= NumToApply;
+
+        if (bBatch)
+        {
+            Self->OnBatchCompleted.Broadcast(Completed);
+        }
+    });
+}
+
+void FCommandRouter::StoreOutcome(const TSharedRef<FControlCommand>& Command, EControlCommandStatus NewStatus,
+    const FString& Error, const TSharedPtr<FJsonValue>& Result)
+{
+    FCommandShard& Shard = GetShard(Command->CommandId);
+    FScopeLock Lock(&Shard.Mutex);
     Command->Status = NewStatus;
     if (!Error.IsEmpty())
     {
         Command->Error = Error;
     }
+    if (Result.IsValid())
+    {
+        Command->Result = Result;
+    }
+}
+
+void FCommandRouter::UpdateStatus(TSharedRef<FControlCommand> Command,
+    EControlCommandStatus NewStatus, const FString& Error, const TSharedPtr<FJsonValue>& Result)
+{
+    StoreOutcome(Command, NewStatus, Error, Result);
 
     UE_LOG(LogCommandRouter, Log, TEXT("Command %s -> %s"),
         *Command->CommandId, *CommandStatusToString(NewStatus));
 
     OnStatusChanged.Broadcast(*Command);
+
+    if (IsTerminalStatus(NewStatus))
+    {
+        NotifyWaiters(Command);
+    }
 }
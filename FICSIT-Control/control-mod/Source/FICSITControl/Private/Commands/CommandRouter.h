@@ -5,12 +5,24 @@
 #include "ICommandExecutor.h"
 
 DECLARE_MULTICAST_DELEGATE_OneParam(FOnCommandStatusChanged, const FControlCommand& /* Command */);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnCommandBatchCompleted, const TArray<FControlCommand>& /* Commands */);
 
 /**
  * Routes incoming commands to the appropriate executor.
  * Manages command lifecycle, idempotency deduplication, and rate limiting.
+ * Payloads are validated on the submitting thread; only Apply runs on the
+ * game thread, with a whole batch sharing a single game-thread task.
+ * Settled commands are kept in a compact form (serialized JSON, interned
+ * type) for lookups and idempotency until retention drops them, oldest
+ * first, so the store stays bounded however long the server runs.
+ *
+ * The command table is split into shards by command ID, each with its own
+ * lock, so status lookups and waits only contend with work on the same
+ * shard. Admission (rate limit, idempotency, pending cap) has a lock of its
+ * own, held only to create commands: validation, dispatch and status
+ * broadcasts all run after it is released.
  */
-class FICSITCONTROL_API FCommandRouter
+class FICSITCONTROL_API FCommandRouter : public TSharedFromThis<FCommandRouter>
 {
 public:
     FCommandRouter();
@@ -25,44 +37,206 @@ public:
     /** Set rate limit (commands per second) */
     void SetRateLimit(int32 InLimit) { RateLimit = InLimit; }
 
+    /** Commands per second accepted through batches, across all of them */
+    void SetBatchRateLimit(int32 InLimit) { BatchRateLimit = InLimit; }
+
+    /**
+     * Cap on commands waiting for the game thread. Single commands may fill
+     * it; a batch (bulk traffic) is refused if it would take more than half,
+     * so batches must be well below InLimit / 2 (see MaxBatchSize).
+     */
+    void SetMaxPendingCommands(int32 InLimit) { MaxPendingCommands = InLimit; }
+
+    /**
+     * Forget commands MaxAge seconds after they were submitted (0 = no age
+     * limit), and keep at most MaxCount. Commands still running are kept.
+     */
+    void SetRetention(float InMaxAge, int32 InMaxCount)
+    {
+        RetentionSeconds = InMaxAge;
+        MaxRetainedCommands = InMaxCount;
+    }
+
     /**
      * Submit a new command. Returns the created command with QUEUED status.
      * If an idempotency key collision is found, returns the existing command.
+     * Issuer is the submitting token's fingerprint, carried on the command's events.
      */
     FControlCommand SubmitCommand(const FString& IdempotencyKey, const FString& Type,
-        TSharedPtr<FJsonObject> Payload);
+        TSharedPtr<FJsonObject> Payload, const FString& Issuer = FString());
+
+    /** Submit a new command, carrying the request's issuer and WebSocket correlation onto it */
+    FControlCommand SubmitCommand(const FControlCommandRequest& Request);
+
+    /**
+     * Submit several commands at once. The batch takes the admission lock and
+     * the rate limiter once, validates every item here, and applies all valid
+     * items in one game-thread task. Returns one command per request, in order.
+     * The whole batch is refused as overloaded unless it fits, together with
+     * the commands already pending, in half of MaxPendingCommands, and as
+     * rate limited unless its commands fit in the batch budget.
+     */
+    TArray<FControlCommand> SubmitBatch(const TArray<FControlCommandRequest>& Requests);
 
-    /** Look up a command by ID */
+    /** Look up a command by ID: a snapshot, null once retention dropped it */
     TSharedPtr<FControlCommand> GetCommand(const FString& CommandId) const;
 
+    /** Live and retained command counts and evictions for /control/v1/stats */
+    TSharedRef<FJsonObject> GetStatsJson() const;
+
+    /**
+     * Register a one-shot callback for when the command reaches SUCCEEDED or
+     * FAILED. Runs immediately if it already has, otherwise on the game thread
+     * as it settles. Returns false if the command is unknown.
+     */
+    bool WaitForCompletion(const FString& CommandId, TFunction<void(const FControlCommand&)> OnSettled);
+
     /** Broadcast delegate for status changes (used by WebSocket server) */
     FOnCommandStatusChanged OnStatusChanged;
 
+    /** Broadcast once per batch after all of its commands were applied */
+    FOnCommandBatchCompleted OnBatchCompleted;
+
 private:
+    /** A created command and the executor that will apply it (null if validation failed) */
+    struct FPendingCommand
+    {
+        TSharedRef<FControlCommand> Command;
+        TSharedPtr<ICommandExecutor> Executor;
+    };
+
+    /** A settled command: payload and result serialized, type interned */
+    struct FRetainedCommand
+    {
+        FString IdempotencyKey;
+        FString RequestId;
+        FString Error;
+        FName Type;
+        EControlCommandStatus Status = EControlCommandStatus::Succeeded;
+        double CreatedTime = 0.0;
+        /** Compact UTF-8 JSON; empty when there was none */
+        TArray<uint8> Payload;
+        TArray<uint8> Result;
+    };
+
+    /** When a command was created, for eviction in creation order */
+    struct FCommandAge
+    {
+        FString CommandId;
+        double CreatedTime;
+    };
+
+    /** One slice of the command table; a command's ID picks its shard */
+    struct alignas(PLATFORM_CACHE_LINE_SIZE) FCommandShard
+    {
+        /** Commands not yet settled */
+        TMap<FString, TSharedRef<FControlCommand>> Live;
+
+        /** Settled commands, until retention drops them */
+        TMap<FString, FRetainedCommand> Retained;
+
+        /** Completion waiters: command ID -> callbacks. Released when the command settles. */
+        TMap<FString, TArray<TFunction<void(const FControlCommand&)>>> Waiters;
+
+        mutable FCriticalSection Mutex;
+    };
+
+    /** The shard holding a command */
+    FCommandShard& GetShard(const FString& CommandId) { return Shards[GetTypeHash(CommandId) % NumShards]; }
+    const FCommandShard& GetShard(const FString& CommandId) const { return Shards[GetTypeHash(CommandId) % NumShards]; }
+
     /** Generate a unique command ID */
     FString GenerateCommandId() const;
 
     /** Check rate limit. Returns true if the command is allowed. */
     bool CheckRateLimit();
 
+    /** Check the batch budget. Returns true if NumCommands more fit in the last second. */
+    bool CheckBatchRateLimit(int32 NumCommands);
+
+    /**
+     * Create, index and return a QUEUED command, reserving its place in the
+     * game-thread queue. Caller holds AdmissionMutex.
+     */
+    TSharedRef<FControlCommand> CreateCommand(const FControlCommandRequest& Request);
+
+    /**
+     * Apply commands in one game-thread task. Batches report through
+     * OnBatchCompleted. Each command with an executor was reserved by CreateCommand.
+     */
+    void DispatchToGameThread(TArray<FPendingCommand>&& Pending, bool bBatch);
+
+    /** Fire and clear the waiters of a command that just settled, and retire it */
+    void NotifyWaiters(const TSharedRef<FControlCommand>& Command);
+
+    /** Find a live or retained command; takes its shard's lock. Expired retained commands are not found. */
+    bool FindCommand(const FString& CommandId, FControlCommand& OutCommand) const;
+
+    /** Whether a settled command is past the age limit, whether or not it was pruned yet */
+    bool IsExpired(const FRetainedCommand& Retained, double Now) const;
+
+    /** Replace a settled command with its compact form. Caller holds the shard's lock. */
+    void RetireCommand(const FString& CommandId, FRetainedCommand&& Compact);
+
+    /** Serialize a settled command into its compact form */
+    static FRetainedCommand CompactCommand(const FControlCommand& Command);
+
+    /**
+     * Drop the oldest retained commands past the age or count limit. Commands
+     * still running are skipped and kept. Caller holds AdmissionMutex.
+     */
+    void PruneRetained(double Now);
+
+    /** Rebuild a full command from its compact form */
+    static FControlCommand ExpandCommand(const FString& CommandId, const FRetainedCommand& Retained);
+
+    /**
+     * Set a published command's status, and its error and result when given,
+     * under its shard lock. The only way a command is changed once created.
+     */
+    void StoreOutcome(const TSharedRef<FControlCommand>& Command, EControlCommandStatus NewStatus,
+        const FString& Error = FString(), const TSharedPtr<FJsonValue>& Result = nullptr);
+
     /** Update a command's status and broadcast the change */
     void UpdateStatus(TSharedRef<FControlCommand> Command, EControlCommandStatus NewStatus,
-        const FString& Error = TEXT(""));
+        const FString& Error = TEXT(""), const TSharedPtr<FJsonValue>& Result = nullptr);
 
     /** All registered executors, keyed by command type */
     TMap<FString, TSharedRef<ICommandExecutor>> Executors;
 
-    /** All commands, keyed by command ID */
-    TMap<FString, TSharedRef<FControlCommand>> Commands;
+    /** Live and retained commands; a power of two, enough that lookups rarely meet */
+    static constexpr int32 NumShards = 16;
+    FCommandShard Shards[NumShards];
 
-    /** Idempotency index: idempotency key -> command ID */
+    /** Admission state below is guarded by AdmissionMutex */
+
+    /** Every live and retained command, oldest first; entries before OrderHead are gone */
+    TArray<FCommandAge> CommandOrder;
+    int32 OrderHead = 0;
+
+    /** Idempotency index: idempotency key -> command ID, pruned with the commands */
     TMap<FString, FString> IdempotencyIndex;
 
     /** Timestamps of recent commands for rate limiting */
     TArray<double> RecentCommandTimes;
 
+    /** Time and size of recent batches for the batch budget */
+    TArray<TPair<double, int32>> RecentBatches;
+
     UWorld* World = nullptr;
     int32 RateLimit = 5;
+    int32 BatchRateLimit = 500;
+    int32 MaxPendingCommands = 1000;
+    float RetentionSeconds = 3600.0f;
+    int32 MaxRetainedCommands = 10000;
+
+    /** Serialized bytes held by retained commands, and how many were dropped */
+    TAtomic<int64> RetainedBytes { 0 };
+    TAtomic<int64> EvictedCommands { 0 };
+
+    /** Commands reserved for or handed to the game thread and not yet applied */
+    TAtomic<int32> PendingCommands { 0 };
 
-    mutable FCriticalSection Mutex;
+    /** Serializes submissions: rate limiter, idempotency index, creation order */
+    FCriticalSection AdmissionMutex;
 };
@@ -6,7 +6,8 @@
 /**
  * Interface for command executors.
  * Each command type (RESET_FUSE, TOGGLE_BUILDING, etc.) has its own executor.
- * Executors run on the game thread when they need to interact with game objects.
+ * Validation runs on the submitting thread; the command router then schedules
+ * Apply on the game thread, grouping whole batches into a single task.
  */
 class ICommandExecutor
 {
@@ -14,13 +15,22 @@ public:
     virtual ~ICommandExecutor() = default;
 
     /**
-     * Execute a command. Called from the command router.
-     * Implementations must schedule game thread work via AsyncTask if needed.
+     * Check the command payload without touching game objects.
+     * Called off the game thread, before the command is dispatched.
      *
-     * @param Command The command to execute (status will be updated in place)
+     * @param Command The command to validate
+     * @param OutError Reason for rejection when returning false
+     */
+    virtual bool Validate(const FControlCommand& Command, FString& OutError) const = 0;
+
+    /**
+     * Apply a validated command. Always called on the game thread.
+     * Implementations set Status, Result and Error on the command.
+     *
+     * @param Command The command to apply (status will be updated in place)
      * @param World The game world for actor lookups
      */
-    virtual void Execute(TSharedRef<FControlCommand> Command, UWorld* World) = 0;
+    virtual void Apply(TSharedRef<FControlCommand> Command, UWorld* World) = 0;
 
     /** Return the command type this executor handles (e.g., "RESET_FUSE") */
     virtual FString GetCommandType() const = 0;
@@ -1,5 +1,4 @@
 #include "ResetFuseExecutor.h"
-#include "Async/Async.h"
 
 // FactoryGame power circuit includes
 #include "FGPowerCircuit.h"
@@ -8,78 +7,71 @@
 
 DEFINE_LOG_CATEGORY_STATIC(LogResetFuse, Log, All);
 
-void FResetFuseExecutor::Execute(TSharedRef<FControlCommand> Command, UWorld* World)
+bool FResetFuseExecutor::Validate(const FControlCommand& Command, FString& OutError) const
 {
-    if (!World)
-    {
-        Command->Status = EControlCommandStatus::Failed;
-        Command->Error = TEXT("World not available");
-        return;
-    }
-
     // Extract circuit ID from payload
-    if (!Command->Payload.IsValid())
+    if (!Command.Payload.IsValid())
     {
-        Command->Status = EControlCommandStatus::Failed;
-        Command->Error = TEXT("Missing payload");
-        return;
+        OutError = TEXT("Missing payload");
+        return false;
     }
 
     int32 CircuitId = 0;
-    if (!Command->Payload->TryGetNumberField(TEXT("circuitId"), CircuitId))
+    if (!Command.Payload->TryGetNumberField(TEXT("circuitId"), CircuitId))
     {
-        Command->Status = EControlCommandStatus::Failed;
-        Command->Error = TEXT("Missing or invalid circuitId in payload");
-        return;
+        OutError = TEXT("Missing or invalid circuitId in payload");
+        return false;
     }
 
-    // Schedule on game thread
-    TSharedRef<FControlCommand> CmdRef = Command;
-
-    AsyncTask(ENamedThreads::GameThread, [CmdRef, CircuitId, World]()
-    {
-        // Find the power circuit by iterating subsystem circuits
-        UFGPowerCircuit* TargetCircuit = nullptr;
+    return true;
+}
 
-        // Get the power circuit subsystem
-        AFGCircuitSubsystem* CircuitSubsystem = AFGCircuitSubsystem::Get(World);
-        if (CircuitSubsystem)
-        {
-            // Find circuit by ID
-            UFGCircuit* Circuit = CircuitSubsystem->FindCircuit(CircuitId);
-            if (Circuit)
-            {
-                TargetCircuit = Cast<UFGPowerCircuit>(Circuit);
-            }
-        }
+void FResetFuseExecutor::Apply(TSharedRef<FControlCommand> Command, UWorld* World)
+{
+    int32 CircuitId = 0;
+    Command->Payload->TryGetNumberField(TEXT("circuitId"), CircuitId);
 
-        if (!TargetCircuit)
-        {
-            CmdRef->Status = EControlCommandStatus::Failed;
-            CmdRef->Error = FString::Printf(TEXT("Power circuit %d not found"), CircuitId);
-            UE_LOG(LogResetFuse, Warning, TEXT("Circuit %d not found"), CircuitId);
-            return;
-        }
+    // Find the power circuit by iterating subsystem circuits
+    UFGPowerCircuit* TargetCircuit = nullptr;
 
-        if (!TargetCircuit->IsFuseTriggered())
+    // Get the power circuit subsystem
+    AFGCircuitSubsystem* CircuitSubsystem = AFGCircuitSubsystem::Get(World);
+    if (CircuitSubsystem)
+    {
+        // Find circuit by ID
+        UFGCircuit* Circuit = CircuitSubsystem->FindCircuit(CircuitId);
+        if (Circuit)
         {
-            // Not tripped — succeed silently (idempotent)
-            CmdRef->Status = EControlCommandStatus::Succeeded;
-            auto Result = MakeShared<FJsonObject>();
-            Result->SetStringField(TEXT("message"), TEXT("Fuse was not tripped"));
-            CmdRef->Result = MakeShared<FJsonValueObject>(Result);
-            UE_LOG(LogResetFuse, Log, TEXT("Circuit %d fuse not tripped, no-op"), CircuitId);
-            return;
+            TargetCircuit = Cast<UFGPowerCircuit>(Circuit);
         }
+    }
 
-        TargetCircuit->ResetFuse();
+    if (!TargetCircuit)
+    {
+        Command->Status = EControlCommandStatus::Failed;
+        Command->Error = FString::Printf(TEXT("Power circuit %d not found"), CircuitId);
+        UE_LOG(LogResetFuse, Warning, TEXT("Circuit %d not found"), CircuitId);
+        return;
+    }
 
-        CmdRef->Status = EControlCommandStatus::Succeeded;
+    if (!TargetCircuit->IsFuseTriggered())
+    {
+        // Not tripped — succeed silently (idempotent)
+        Command->Status = EControlCommandStatus::Succeeded;
         auto Result = MakeShared<FJsonObject>();
-        Result->SetStringField(TEXT("message"),
-            FString::Printf(TEXT("Reset fuse on circuit %d"), CircuitId));
-        CmdRef->Result = MakeShared<FJsonValueObject>(Result);
+        Result->SetStringField(TEXT("message"), TEXT("Fuse was not tripped"));
+        Command->Result = MakeShared<FJsonValueObject>(Result);
+        UE_LOG(LogResetFuse, Log, TEXT("Circuit %d fuse not tripped, no-op"), CircuitId);
+        return;
+    }
+
+    TargetCircuit->ResetFuse();
+
+    Command->Status = EControlCommandStatus::Succeeded;
+    auto Result = MakeShared<FJsonObject>();
+    Result->SetStringField(TEXT("message"),
+        FString::Printf(TEXT("Reset fuse on circuit %d"), CircuitId));
+    Command->Result = MakeShared<FJsonValueObject>(Result);
 
-        UE_LOG(LogResetFuse, Log, TEXT("Reset fuse on circuit %d"), CircuitId);
-    });
+    UE_LOG(LogResetFuse, Log, TEXT("Reset fuse on circuit %d"), CircuitId);
 }
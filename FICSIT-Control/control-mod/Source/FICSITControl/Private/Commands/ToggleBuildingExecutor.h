@@ -10,6 +10,7 @@
 class FToggleBuildingExecutor : public ICommandExecutor
 {
 public:
-    virtual void Execute(TSharedRef<FControlCommand> Command, UWorld* World) override;
+    virtual bool Validate(const FControlCommand& Command, FString& OutError) const override;
+    virtual void Apply(TSharedRef<FControlCommand> Command, UWorld* World) override;
     virtual FString GetCommandType() const override { return TEXT("TOGGLE_BUILDING"); }
 };
@@ -2,78 +2,72 @@
 #include "Buildables/FGBuildableGeneratorFuel.h"
 #include "Buildables/FGBuildableGeneratorNuclear.h"
 #include "EngineUtils.h"
-#include "Async/Async.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogToggleGenGroup, Log, All);
 
-void FToggleGeneratorGroupExecutor::Execute(TSharedRef<FControlCommand> Command, UWorld* World)
+bool FToggleGeneratorGroupExecutor::Validate(const FControlCommand& Command, FString& OutError) const
 {
-    if (!World)
+    if (!Command.Payload.IsValid())
     {
-        Command->Status = EControlCommandStatus::Failed;
-        Command->Error = TEXT("World not available");
-        return;
-    }
-
-    if (!Command->Payload.IsValid())
-    {
-        Command->Status = EControlCommandStatus::Failed;
-        Command->Error = TEXT("Missing payload");
-        return;
+        OutError = TEXT("Missing payload");
+        return false;
     }
 
     FString GroupId;
-    if (!Command->Payload->TryGetStringField(TEXT("groupId"), GroupId))
+    if (!Command.Payload->TryGetStringField(TEXT("groupId"), GroupId))
     {
-        Command->Status = EControlCommandStatus::Failed;
-        Command->Error = TEXT("Missing groupId in payload");
-        return;
+        OutError = TEXT("Missing groupId in payload");
+        return false;
     }
 
     bool bEnabled = false;
-    if (!Command->Payload->TryGetBoolField(TEXT("enabled"), bEnabled))
+    if (!Command.Payload->TryGetBoolField(TEXT("enabled"), bEnabled))
     {
-        Command->Status = EControlCommandStatus::Failed;
-        Command->Error = TEXT("Missing enabled in payload");
-        return;
+        OutError = TEXT("Missing enabled in payload");
+        return false;
     }
 
-    TSharedRef<FControlCommand> CmdRef = Command;
+    return true;
+}
 
-    AsyncTask(ENamedThreads::GameThread, [CmdRef, GroupId, bEnabled, World]()
-    {
-        // GroupId is the class name of the generator type (e.g., "Build_GeneratorCoal_C")
-        int32 ToggleCount = 0;
+void FToggleGeneratorGroupExecutor::Apply(TSharedRef<FControlCommand> Command, UWorld* World)
+{
+    FString GroupId;
+    bool bEnabled = false;
+    Command->Payload->TryGetStringField(TEXT("groupId"), GroupId);
+    Command->Payload->TryGetBoolField(TEXT("enabled"), bEnabled);
 
-        for (TActorIterator<AFGBuildableGenerator> It(World); It; ++It)
-        {
-            AFGBuildableGenerator* Generator = *It;
-            if (!Generator) continue;
+    // GroupId is the class name of the generator type (e.g., "Build_GeneratorCoal_C")
+    int32 ToggleCount = 0;
 
-            FString ClassName = Generator->GetClass()->GetName();
-            if (ClassName == GroupId)
-            {
-                Generator->SetIsProductionPaused(!bEnabled);
-                ToggleCount++;
-            }
-        }
+    for (TActorIterator<AFGBuildableGenerator> It(World); It; ++It)
+    {
+        AFGBuildableGenerator* Generator = *It;
+        if (!Generator) continue;
 
-        if (ToggleCount == 0)
+        FString ClassName = Generator->GetClass()->GetName();
+        if (ClassName == GroupId)
         {
-            CmdRef->Status = EControlCommandStatus::Failed;
-            CmdRef->Error = FString::Printf(TEXT("No generators found for group: %s"), *GroupId);
-            return;
+            Generator->SetIsProductionPaused(!bEnabled);
+            ToggleCount++;
         }
+    }
+
+    if (ToggleCount == 0)
+    {
+        Command->Status = EControlCommandStatus::Failed;
+        Command->Error = FString::Printf(TEXT("No generators found for group: %s"), *GroupId);
+        return;
+    }
 
-        CmdRef->Status = EControlCommandStatus::Succeeded;
-        auto Result = MakeShared<FJsonObject>();
-        Result->SetStringField(TEXT("message"),
-            FString::Printf(TEXT("%s %d generators in group %s"),
-                bEnabled ? TEXT("Enabled") : TEXT("Disabled"), ToggleCount, *GroupId));
-        Result->SetNumberField(TEXT("count"), ToggleCount);
-        CmdRef->Result = MakeShared<FJsonValueObject>(Result);
+    Command->Status = EControlCommandStatus::Succeeded;
+    auto Result = MakeShared<FJsonObject>();
+    Result->SetStringField(TEXT("message"),
+        FString::Printf(TEXT("%s %d generators in group %s"),
+            bEnabled ? TEXT("Enabled") : TEXT("Disabled"), ToggleCount, *GroupId));
+    Result->SetNumberField(TEXT("count"), ToggleCount);
+    Command->Result = MakeShared<FJsonValueObject>(Result);
 
-        UE_LOG(LogToggleGenGroup, Log, TEXT("%s %d generators in group %s"),
-            bEnabled ? TEXT("Enabled") : TEXT("Disabled"), ToggleCount, *GroupId);
-    });
+    UE_LOG(LogToggleGenGroup, Log, TEXT("%s %d generators in group %s"),
+        bEnabled ? TEXT("Enabled") : TEXT("Disabled"), ToggleCount, *GroupId);
 }
@@ -38,6 +38,74 @@ void FControlConfig::LoadFromIni()
     {
         WsPort = FCString::Atoi(*Value);
     }
+    if (ConfigFile.GetString(TEXT("Network"), TEXT("KeepAliveTimeout"), Value))
+    {
+        KeepAliveTimeout = FCString::Atof(*Value);
+    }
+    if (ConfigFile.GetString(TEXT("Network"), TEXT("MaxKeepAliveRequests"), Value))
+    {
+        MaxKeepAliveRequests = FCString::Atoi(*Value);
+    }
+    if (ConfigFile.GetString(TEXT("Network"), TEXT("WorkerThreads"), Value))
+    {
+        WorkerThreads = FCString::Atoi(*Value);
+    }
+    if (ConfigFile.GetString(TEXT("Network"), TEXT("RequestTimeout"), Value))
+    {
+        RequestTimeout = FCString::Atof(*Value);
+    }
+    if (ConfigFile.GetString(TEXT("Network"), TEXT("WriteTimeout"), Value))
+    {
+        WriteTimeout = FCString::Atof(*Value);
+    }
+    if (ConfigFile.GetString(TEXT("Network"), TEXT("HttpSocketPath"), Value))
+    {
+        HttpSocketPath = Value;
+    }
+    if (ConfigFile.GetString(TEXT("Network"), TEXT("WsSocketPath"), Value))
+    {
+        WsSocketPath = Value;
+    }
+    if (ConfigFile.GetString(TEXT("Network"), TEXT("SocketFileMode"), Value))
+    {
+        SocketFileMode = FCString::Strtoi(*Value, nullptr, 8);
+    }
+    if (ConfigFile.GetString(TEXT("Network"), TEXT("WsDeflate"), Value))
+    {
+        bWsDeflate = FCString::ToBool(*Value);
+    }
+    if (ConfigFile.GetString(TEXT("Network"), TEXT("WsDeflateWindowBits"), Value))
+    {
+        WsDeflateWindowBits = FMath::Clamp(FCString::Atoi(*Value), 9, 15);
+    }
+    if (ConfigFile.GetString(TEXT("Network"), TEXT("WsDeflateThreshold"), Value))
+    {
+        WsDeflateThreshold = FCString::Atoi(*Value);
+    }
+    if (ConfigFile.GetString(TEXT("Network"), TEXT("WsBinaryEvents"), Value))
+    {
+        bWsBinaryEvents = FCString::ToBool(*Value);
+    }
+    if (ConfigFile.GetString(TEXT("Network"), TEXT("WsPingInterval"), Value))
+    {
+        WsPingInterval = FMath::Max(FCString::Atof(*Value), 0.0f);
+    }
+    if (ConfigFile.GetString(TEXT("Network"), TEXT("WsMaxMissedPongs"), Value))
+    {
+        WsMaxMissedPongs = FMath::Max(FCString::Atoi(*Value), 1);
+    }
+    if (ConfigFile.GetString(TEXT("Network"), TEXT("EventFlushInterval"), Value))
+    {
+        EventFlushInterval = FCString::Atof(*Value);
+    }
+    if (ConfigFile.GetString(TEXT("Network"), TEXT("EventBatchSize"), Value))
+    {
+        EventBatchSize = FCString::Atoi(*Value);
+    }
+    if (ConfigFile.GetString(TEXT("Network"), TEXT("EventHistorySize"), Value))
+    {
+        EventHistorySize = FMath::Max(FCString::Atoi(*Value), 1);
+    }
 
     // Security
     if (ConfigFile.GetString(TEXT("Security"), TEXT("AuthToken"), Value))
@@ -50,6 +118,66 @@ void FControlConfig::LoadFromIni()
     {
         RateLimit = FCString::Atoi(*Value);
     }
+    if (ConfigFile.GetString(TEXT("Limits"), TEXT("BatchRateLimit"), Value))
+    {
+        BatchRateLimit = FMath::Max(FCString::Atoi(*Value), 1);
+    }
+    if (ConfigFile.GetString(TEXT("Limits"), TEXT("MaxHeaderBytes"), Value))
+    {
+        MaxHeaderBytes = FCString::Atoi(*Value);
+    }
+    if (ConfigFile.GetString(TEXT("Limits"), TEXT("MaxRequestBodyBytes"), Value))
+    {
+        MaxRequestBodyBytes = FCString::Atoi(*Value);
+    }
+    if (ConfigFile.GetString(TEXT("Limits"), TEXT("MaxBatchSize"), Value))
+    {
+        MaxBatchSize = FCString::Atoi(*Value);
+    }
+    if (ConfigFile.GetString(TEXT("Limits"), TEXT("MaxConnections"), Value))
+    {
+        MaxConnections = FCString::Atoi(*Value);
+    }
+    if (ConfigFile.GetString(TEXT("Limits"), TEXT("MaxTotalConnections"), Value))
+    {
+        MaxTotalConnections = FCString::Atoi(*Value);
+    }
+    if (ConfigFile.GetString(TEXT("Limits"), TEXT("MaxInFlightRequests"), Value))
+    {
+        MaxInFlightRequests = FCString::Atoi(*Value);
+    }
+    if (ConfigFile.GetString(TEXT("Limits"), TEXT("MaxPendingCommands"), Value))
+    {
+        MaxPendingCommands = FCString::Atoi(*Value);
+    }
+    if (ConfigFile.GetString(TEXT("Limits"), TEXT("CommandRetentionSeconds"), Value))
+    {
+        CommandRetentionSeconds = FMath::Max(FCString::Atof(*Value), 0.0f);
+    }
+    if (ConfigFile.GetString(TEXT("Limits"), TEXT("MaxRetainedCommands"), Value))
+    {
+        MaxRetainedCommands = FMath::Max(FCString::Atoi(*Value), 1);
+    }
+    if (ConfigFile.GetString(TEXT("Limits"), TEXT("WsMaxQueuedBytes"), Value))
+    {
+        WsMaxQueuedBytes = FCString::Atoi(*Value);
+    }
+    if (ConfigFile.GetString(TEXT("Limits"), TEXT("SseMaxQueuedBytes"), Value))
+    {
+        SseMaxQueuedBytes = FMath::Max(FCString::Atoi(*Value), 1024);
+    }
+
+    // Batches are refused once they would take the pending queue past half,
+    // so a batch larger than that could never be admitted; a quarter leaves
+    // room for one full batch while others are still queued
+    const int32 BatchSizeCap = FMath::Clamp(MaxPendingCommands / 4, 1, BatchRateLimit);
+    if (MaxBatchSize > BatchSizeCap || MaxBatchSize < 1)
+    {
+        UE_LOG(LogControlConfig, Warning,
+            TEXT("MaxBatchSize=%d does not fit MaxPendingCommands=%d and BatchRateLimit=%d, using %d"),
+            MaxBatchSize, MaxPendingCommands, BatchRateLimit, BatchSizeCap);
+        MaxBatchSize = FMath::Clamp(MaxBatchSize, 1, BatchSizeCap);
+    }
 
     // Features
     bool BoolValue;
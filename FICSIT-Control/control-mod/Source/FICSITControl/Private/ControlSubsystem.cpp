@@ -7,6 +7,9 @@
 #include "Commands/SetOverclockExecutor.h"
 #include "Commands/ToggleGeneratorGroupExecutor.h"
 #include "WebSocket/WsServer.h"
+#include "Net/SocketReactor.h"
+#include "Events/ControlEventJournal.h"
+#include "Events/ControlEventCoalescer.h"
 #include "Config/ControlConfig.h"
 #include "Kismet/GameplayStatics.h"
 
@@ -14,8 +17,8 @@ DEFINE_LOG_CATEGORY_STATIC(LogControlSubsystem, Log, All);
 
 AControlSubsystem::AControlSubsystem()
 {
-    PrimaryActorTick.bCanEverTick = true;
-    PrimaryActorTick.TickInterval = 0.1f; // 10 Hz for WS housekeeping
+    // All socket work runs on the reactor thread; nothing to do per frame
+    PrimaryActorTick.bCanEverTick = false;
 }
 
 AControlSubsystem* AControlSubsystem::Get(UWorld* World)
@@ -42,6 +45,9 @@ void AControlSubsystem::BeginPlay()
     CommandRouter = MakeShared<FCommandRouter>();
     CommandRouter->SetWorld(GetWorld());
     CommandRouter->SetRateLimit(Config.RateLimit);
+    CommandRouter->SetBatchRateLimit(Config.BatchRateLimit);
+    CommandRouter->SetMaxPendingCommands(Config.MaxPendingCommands);
+    CommandRouter->SetRetention(Config.CommandRetentionSeconds, Config.MaxRetainedCommands);
 
     // Register command executors
     CommandRouter->RegisterExecutor(MakeShared<FResetFuseExecutor>());
@@ -50,42 +56,114 @@ void AControlSubsystem::BeginPlay()
     CommandRouter->RegisterExecutor(MakeShared<FSetOverclockExecutor>());
     CommandRouter->RegisterExecutor(MakeShared<FToggleGeneratorGroupExecutor>());
 
+    // Single network thread shared by both listeners
+    Reactor = MakeShared<FSocketReactor>();
+    Reactor->SetMaxConnections(Config.MaxTotalConnections);
+    if (!Reactor->Start(Config.WorkerThreads))
+    {
+        UE_LOG(LogControlSubsystem, Error, TEXT("Failed to start FICSIT Control socket reactor"));
+        Reactor.Reset();
+        return;
+    }
+
     // Initialize WebSocket server
     WsServer = MakeShared<FWsServer>();
+    WsServer->SetMaxConnections(Config.MaxConnections);
+    WsServer->SetHandshakeLimits(Config.MaxHeaderBytes, Config.RequestTimeout);
+    WsServer->SetMaxQueuedBytes(Config.WsMaxQueuedBytes);
+    WsServer->SetDeflate(Config.bWsDeflate, Config.WsDeflateWindowBits, Config.WsDeflateThreshold);
+    WsServer->SetBinaryEvents(Config.bWsBinaryEvents);
+    WsServer->SetHeartbeat(Config.WsPingInterval, Config.WsMaxMissedPongs);
+
+    // Wire command router status changes -> event journal, serialized once per event
+    EventJournal = MakeShared<FControlEventJournal>(Config.EventHistorySize);
+    EventJournal->SetEncodeCbor(Config.bWsBinaryEvents);
+
+    // Status changes are gathered on the game thread and published together
+    // from the reactor's workers once per flush interval
+    EventCoalescer = MakeShared<FControlEventCoalescer>(EventJournal.ToSharedRef(), Reactor.ToSharedRef(),
+        Config.EventFlushInterval, Config.EventBatchSize);
 
-    // Wire command router status changes -> WS broadcast
     CommandRouter->OnStatusChanged.AddLambda(
         [this](const FControlCommand& Command)
         {
-            if (WsServer.IsValid())
+            if (EventCoalescer.IsValid())
             {
-                WsServer->BroadcastCommandStatus(Command);
+                EventCoalescer->Add(Command);
+            }
+        });
+
+    CommandRouter->OnBatchCompleted.AddLambda(
+        [this](const TArray<FControlCommand>& Commands)
+        {
+            if (EventCoalescer.IsValid())
+            {
+                EventCoalescer->Add(Commands);
             }
         });
 
     // Initialize HTTP server
     HttpServer = MakeShared<FControlHttpServer>();
 
+    HttpServer->SetKeepAlive(Config.KeepAliveTimeout, Config.MaxKeepAliveRequests);
+    HttpServer->SetTimeouts(Config.RequestTimeout, Config.WriteTimeout);
+    HttpServer->SetMaxHeaderBytes(Config.MaxHeaderBytes);
+    HttpServer->SetMaxBodyBytes(Config.MaxRequestBodyBytes);
+    HttpServer->SetMaxBatchSize(Config.MaxBatchSize);
+    HttpServer->SetMaxStreamQueuedBytes(Config.SseMaxQueuedBytes);
+    HttpServer->SetAdmissionLimits(Config.MaxConnections, Config.MaxInFlightRequests);
+    HttpServer->SetEventJournal(EventJournal);
+    WsServer->SetEventJournal(EventJournal);
+
+    // Fan each journaled event out to WebSocket clients and SSE streams
+    EventJournal->OnPublished.AddLambda(
+        [this](const TSharedRef<const FControlEvent>& Event)
+        {
+            if (WsServer.IsValid())
+            {
+                WsServer->BroadcastEvent(*Event);
+            }
+            if (HttpServer.IsValid())
+            {
+                HttpServer->BroadcastEvent(*Event);
+            }
+        });
+
     // Configure auth token and capabilities from config
     if (!Config.AuthToken.IsEmpty())
     {
         HttpServer->GetAuth().SetToken(Config.AuthToken);
     }
     {
-        FControlCapabilities& Caps = HttpServer->GetCapabilities();
+        FControlCapabilities Caps;
         Caps.bResetFuse = Config.bResetFuse;
         Caps.bToggleBuilding = Config.bToggleBuilding;
         Caps.bSetRecipe = Config.bSetRecipe;
         Caps.bSetOverclock = Config.bSetOverclock;
         Caps.bToggleGeneratorGroup = Config.bToggleGeneratorGroup;
         Caps.CommandsPerSecond = Config.RateLimit;
+        Caps.BatchCommandsPerSecond = Config.BatchRateLimit;
+        Caps.MaxBatchSize = Config.MaxBatchSize;
+        HttpServer->SetCapabilities(Caps);
     }
 
     // Wire up HTTP server -> command router delegates
     HttpServer->OnCommandReceived.BindLambda(
-        [this](const FString& Type, TSharedPtr<FJsonObject> Payload) -> FControlCommand
+        [this](const FString& Type, TSharedPtr<FJsonObject> Payload, const FString& Issuer) -> FControlCommand
+        {
+            return CommandRouter->SubmitCommand(FGuid::NewGuid().ToString(), Type, Payload, Issuer);
+        });
+
+    WsServer->OnCommandReceived.BindLambda(
+        [this](const FControlCommandRequest& Request) -> FControlCommand
+        {
+            return CommandRouter->SubmitCommand(Request);
+        });
+
+    HttpServer->OnBatchReceived.BindLambda(
+        [this](const TArray<FControlCommandRequest>& Requests) -> TArray<FControlCommand>
         {
-            return CommandRouter->SubmitCommand(FGuid::NewGuid().ToString(), Type, Payload);
+            return CommandRouter->SubmitBatch(Requests);
         });
 
     HttpServer->OnCommandQuery.BindLambda(
@@ -94,18 +172,51 @@ void AControlSubsystem::BeginPlay()
             return CommandRouter->GetCommand(CommandId);
         });
 
-    if (HttpServer->Start(HttpPort))
+    HttpServer->OnCollectStats.BindLambda(
+        [this](const TSharedRef<FJsonObject>& Stats)
+        {
+            Stats->SetObjectField(TEXT("commands"), CommandRouter->GetStatsJson());
+            if (WsServer.IsValid())
+            {
+                Stats->SetObjectField(TEXT("websocket"), WsServer->GetStatsJson());
+            }
+            if (EventCoalescer.IsValid())
+            {
+                auto Events = MakeShared<FJsonObject>();
+                Events->SetNumberField(TEXT("lastSeq"), static_cast<double>(EventJournal->GetLastSeq()));
+                Events->SetNumberField(TEXT("collapsed"), static_cast<double>(EventCoalescer->GetCollapsed()));
+                Stats->SetObjectField(TEXT("events"), Events);
+            }
+        });
+
+    HttpServer->OnCommandWait.BindLambda(
+        [this](const FString& CommandId, TFunction<void(const FControlCommand&)> OnSettled) -> bool
+        {
+            return CommandRouter->WaitForCompletion(CommandId, MoveTemp(OnSettled));
+        });
+
+    if (HttpServer->Start(HttpPort, Reactor.ToSharedRef()))
     {
         UE_LOG(LogControlSubsystem, Log, TEXT("FICSIT Control HTTP server started on port %d"), HttpPort);
+
+        if (!Config.HttpSocketPath.IsEmpty())
+        {
+            HttpServer->StartLocal(Config.HttpSocketPath, Config.SocketFileMode);
+        }
     }
     else
     {
         UE_LOG(LogControlSubsystem, Error, TEXT("Failed to start FICSIT Control HTTP server on port %d"), HttpPort);
     }
 
-    if (WsServer->Start(WsPort, &HttpServer->GetAuth()))
+    if (WsServer->Start(WsPort, &HttpServer->GetAuth(), Reactor.ToSharedRef()))
     {
         UE_LOG(LogControlSubsystem, Log, TEXT("FICSIT Control WebSocket server started on port %d"), WsPort);
+
+        if (!Config.WsSocketPath.IsEmpty())
+        {
+            WsServer->StartLocal(Config.WsSocketPath, Config.SocketFileMode);
+        }
     }
     else
     {
@@ -115,35 +226,49 @@ void AControlSubsystem::BeginPlay()
 
 void AControlSubsystem::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
+    // Send whatever is still buffered while the servers can deliver it. The
+    // coalescer itself stays until the reactor's workers, which feed it
+    // through the router's delegates, have been drained.
+    if (EventCoalescer.IsValid())
+    {
+        EventCoalescer->Flush();
+    }
+
     if (WsServer.IsValid())
     {
         WsServer->Stop();
-        WsServer.Reset();
         UE_LOG(LogControlSubsystem, Log, TEXT("FICSIT Control WebSocket server stopped"));
     }
 
     if (HttpServer.IsValid())
     {
         HttpServer->Stop();
-        HttpServer.Reset();
         UE_LOG(LogControlSubsystem, Log, TEXT("FICSIT Control HTTP server stopped"));
     }
 
-    if (CommandRouter.IsValid())
+    // Drain workers before the servers they reference go away
+    if (Reactor.IsValid())
     {
-        CommandRouter.Reset();
+        Reactor->Shutdown();
+        Reactor.Reset();
     }
 
-    Super::EndPlay(EndPlayReason);
-}
+    // Only the game thread is left to report status changes; stop it first
+    if (CommandRouter.IsValid())
+    {
+        CommandRouter->OnStatusChanged.Clear();
+        CommandRouter->OnBatchCompleted.Clear();
+    }
+    EventCoalescer.Reset();
 
-void AControlSubsystem::Tick(float DeltaTime)
-{
-    Super::Tick(DeltaTime);
+    WsServer.Reset();
+    HttpServer.Reset();
+    EventJournal.Reset();
 
-    // Tick WebSocket server to process incoming frames and clean up dead connections
-    if (WsServer.IsValid())
+    if (CommandRouter.IsValid())
     {
-        WsServer->Tick();
+        CommandRouter.Reset();
     }
+
+    Super::EndPlay(EndPlayReason);
 }
@@ -0,0 +1,237 @@
+#include "ControlEventCbor.h"
+
+// CBOR major types
+static constexpr uint8 MajorUnsigned = 0;
+static constexpr uint8 MajorNegative = 1;
+static constexpr uint8 MajorText = 3;
+static constexpr uint8 MajorArray = 4;
+static constexpr uint8 MajorMap = 5;
+
+// Simple values and float heads (major type 7)
+static constexpr uint8 CborFalse = 0xF4;
+static constexpr uint8 CborTrue = 0xF5;
+static constexpr uint8 CborNull = 0xF6;
+static constexpr uint8 CborFloat32 = 0xFA;
+static constexpr uint8 CborFloat64 = 0xFB;
+
+static constexpr int32 KeyEvent = 0;
+static constexpr int32 KeyCommands = 5;
+static constexpr int32 KeyTimestamp = 6;
+static constexpr int32 KeySeq = 8;
+static constexpr int32 EventCommandBatch = 1;
+
+/** Integer keys for the field names every event uses; the index is the key */
+static const TCHAR* const FieldKeys[] = {
+    TEXT("event"), TEXT("commandId"), TEXT("status"), TEXT("result"),
+    TEXT("error"), TEXT("commands"), TEXT("ts"), TEXT("id"), TEXT("seq"),
+    TEXT("requestId")
+};
+
+static const TCHAR* const EventCodes[] = {
+    TEXT("COMMAND_STATUS"), TEXT("COMMAND_BATCH"), TEXT("SUBSCRIBED"), TEXT("UNSUBSCRIBED"), TEXT("ERROR"),
+    TEXT("RESYNC"), TEXT("COMMAND_ACK")
+};
+
+static const TCHAR* const StatusCodes[] = {
+    TEXT("QUEUED"), TEXT("RUNNING"), TEXT("SUCCEEDED"), TEXT("FAILED")
+};
+
+template <int32 N>
+static int32 FindCode(const TCHAR* const (&Table)[N], const FString& Name)
+{
+    for (int32 i = 0; i < N; ++i)
+    {
+        if (Name.Equals(Table[i], ESearchCase::CaseSensitive))
+        {
+            return i;
+        }
+    }
+    return INDEX_NONE;
+}
+
+static void WriteHead(TArray<uint8>& Out, uint8 Major, uint64 Value)
+{
+    const uint8 Type = Major << 5;
+    if (Value < 24)
+    {
+        Out.Add(Type | static_cast<uint8>(Value));
+        return;
+    }
+
+    int32 Bytes;
+    if (Value <= 0xFF)             { Out.Add(Type | 24); Bytes = 1; }
+    else if (Value <= 0xFFFF)      { Out.Add(Type | 25); Bytes = 2; }
+    else if (Value <= 0xFFFFFFFFu) { Out.Add(Type | 26); Bytes = 4; }
+    else                           { Out.Add(Type | 27); Bytes = 8; }
+
+    // Big-endian argument
+    for (int32 i = Bytes - 1; i >= 0; --i)
+    {
+        Out.Add(static_cast<uint8>(Value >> (i * 8)));
+    }
+}
+
+static void WriteInteger(TArray<uint8>& Out, int64 Value)
+{
+    if (Value >= 0)
+    {
+        WriteHead(Out, MajorUnsigned, static_cast<uint64>(Value));
+    }
+    else
+    {
+        WriteHead(Out, MajorNegative, static_cast<uint64>(-(Value + 1)));
+    }
+}
+
+static void WriteText(TArray<uint8>& Out, const FString& Text)
+{
+    const FTCHARToUTF8 Utf8(*Text);
+    WriteHead(Out, MajorText, Utf8.Length());
+    Out.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+}
+
+static void WriteNumber(TArray<uint8>& Out, double Value)
+{
+    // Integral values up to 2^53 are exact in a double and far smaller as integers
+    if (FMath::IsFinite(Value) && FMath::Abs(Value) <= 9007199254740992.0 && Value == FMath::FloorToDouble(Value))
+    {
+        WriteInteger(Out, static_cast<int64>(Value));
+        return;
+    }
+
+    const float Single = static_cast<float>(Value);
+    if (static_cast<double>(Single) == Value)
+    {
+        uint32 Bits;
+        FMemory::Memcpy(&Bits, &Single, sizeof(Bits));
+        Out.Add(CborFloat32);
+        for (int32 i = 3; i >= 0; --i)
+        {
+            Out.Add(static_cast<uint8>(Bits >> (i * 8)));
+        }
+        return;
+    }
+
+    uint64 Bits;
+    FMemory::Memcpy(&Bits, &Value, sizeof(Bits));
+    Out.Add(CborFloat64);
+    for (int32 i = 7; i >= 0; --i)
+    {
+        Out.Add(static_cast<uint8>(Bits >> (i * 8)));
+    }
+}
+
+static void WriteValue(TArray<uint8>& Out, const TSharedPtr<FJsonValue>& Value);
+
+static void WriteObject(TArray<uint8>& Out, const FJsonObject& Object, int64 TimestampMs)
+{
+    WriteHead(Out, MajorMap, Object.Values.Num() + (TimestampMs != 0 ? 1 : 0));
+
+    for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : Object.Values)
+    {
+        const int32 Key = FindCode(FieldKeys, Field.Key);
+        if (Key == INDEX_NONE)
+        {
+            WriteText(Out, Field.Key);
+            WriteValue(Out, Field.Value);
+            continue;
+        }
+        WriteInteger(Out, Key);
+
+        // Event and status names travel as their codes when they have one
+        FString Name;
+        if (Field.Value.IsValid() && Field.Value->TryGetString(Name) &&
+            (Field.Key == TEXT("event") || Field.Key == TEXT("status")))
+        {
+            const int32 Code = Field.Key == TEXT("event") ? FindCode(EventCodes, Name) : FindCode(StatusCodes, Name);
+            if (Code != INDEX_NONE)
+            {
+                WriteInteger(Out, Code);
+                continue;
+            }
+        }
+        WriteValue(Out, Field.Value);
+    }
+
+    if (TimestampMs != 0)
+    {
+        WriteInteger(Out, KeyTimestamp);
+        WriteInteger(Out, TimestampMs);
+    }
+}
+
+static void WriteValue(TArray<uint8>& Out, const TSharedPtr<FJsonValue>& Value)
+{
+    if (!Value.IsValid())
+    {
+        Out.Add(CborNull);
+        return;
+    }
+
+    switch (Value->Type)
+    {
+    case EJson::String:
+        WriteText(Out, Value->AsString());
+        break;
+
+    case EJson::Number:
+        WriteNumber(Out, Value->AsNumber());
+        break;
+
+    case EJson::Boolean:
+        Out.Add(Value->AsBool() ? CborTrue : CborFalse);
+        break;
+
+    case EJson::Array:
+    {
+        const TArray<TSharedPtr<FJsonValue>>& Items = Value->AsArray();
+        WriteHead(Out, MajorArray, Items.Num());
+        for (const TSharedPtr<FJsonValue>& Item : Items)
+        {
+            WriteValue(Out, Item);
+        }
+        break;
+    }
+
+    case EJson::Object:
+    {
+        const TSharedPtr<FJsonObject> Object = Value->AsObject();
+        if (Object.IsValid())
+        {
+            WriteObject(Out, *Object, 0);
+        }
+        else
+        {
+            Out.Add(CborNull);
+        }
+        break;
+    }
+
+    default:
+        Out.Add(CborNull);
+        break;
+    }
+}
+
+void FControlEventCbor::Encode(const FJsonObject& Json, TArray<uint8>& Out, int64 TimestampMs)
+{
+    WriteObject(Out, Json, TimestampMs);
+}
+
+void FControlEventCbor::BeginBatch(TArray<uint8>& Out, int32 NumItems, uint64 Seq)
+{
+    // { 0: COMMAND_BATCH, 8: seq, 5: [ ...items ], 6: ts }
+    WriteHead(Out, MajorMap, 4);
+    WriteInteger(Out, KeyEvent);
+    WriteInteger(Out, EventCommandBatch);
+    WriteInteger(Out, KeySeq);
+    WriteHead(Out, MajorUnsigned, Seq);
+    WriteInteger(Out, KeyCommands);
+    WriteHead(Out, MajorArray, NumItems);
+}
+
+void FControlEventCbor::EndBatch(TArray<uint8>& Out, int64 TimestampMs)
+{
+    WriteInteger(Out, KeyTimestamp);
+    WriteInteger(Out, TimestampMs);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+
+/**
+ * Compact CBOR (RFC 8949) encoding of outbound events, for clients that
+ * negotiate the binary subprotocol. The structure mirrors the JSON events,
+ * but well-known field names become small integer keys and the event and
+ * status names become integers:
+ *
+ *   0 event      0 COMMAND_STATUS, 1 COMMAND_BATCH, 2 SUBSCRIBED, 3 UNSUBSCRIBED, 4 ERROR,
+ *                5 RESYNC, 6 COMMAND_ACK
+ *   1 commandId
+ *   2 status     0 QUEUED, 1 RUNNING, 2 SUCCEEDED, 3 FAILED
+ *   3 result
+ *   4 error
+ *   5 commands   (array of COMMAND_STATUS maps)
+ *   6 ts         publish time, Unix milliseconds
+ *   7 id         subscription id
+ *   8 seq        journal sequence number
+ *   9 requestId  correlation ID of a command submitted over WebSocket
+ *
+ * Any other field keeps its name as a text key, and unknown event or status
+ * names stay strings, so new fields never break the encoding. Integral
+ * numbers are written as integers and others as the shortest exact float.
+ */
+class FControlEventCbor
+{
+public:
+    /** Append the CBOR encoding of Json to Out; a non-zero TimestampMs adds key 6 */
+    static void Encode(const FJsonObject& Json, TArray<uint8>& Out, int64 TimestampMs = 0);
+
+    /**
+     * Write a COMMAND_BATCH event piecewise: BeginBatch, then NumItems
+     * COMMAND_STATUS maps (each from Encode), then EndBatch.
+     */
+    static void BeginBatch(TArray<uint8>& Out, int32 NumItems, uint64 Seq);
+    static void EndBatch(TArray<uint8>& Out, int64 TimestampMs);
+};
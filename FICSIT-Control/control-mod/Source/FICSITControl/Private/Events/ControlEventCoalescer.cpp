@@ -0,0 +1,101 @@
+#include "ControlEventCoalescer.h"
+#include "ControlEventJournal.h"
+#include "Net/SocketReactor.h"
+
+FControlEventCoalescer::FControlEventCoalescer(TSharedRef<FControlEventJournal> InJournal,
+    TSharedRef<FSocketReactor> InReactor, float InFlushInterval, int32 InMaxBatchSize)
+    : Journal(InJournal)
+    , Reactor(InReactor)
+    , FlushInterval(FMath::Max(InFlushInterval, 0.0f))
+    , MaxBatchSize(FMath::Max(InMaxBatchSize, 1))
+{
+}
+
+FControlEventCoalescer::~FControlEventCoalescer()
+{
+    // Nothing buffered is lost on shutdown
+    Flush();
+}
+
+void FControlEventCoalescer::Add(const FControlCommand& Command)
+{
+    FScopeLock Lock(&PendingMutex);
+    AddLocked(Command);
+    ScheduleFlushLocked();
+}
+
+void FControlEventCoalescer::Add(const TArray<FControlCommand>& Commands)
+{
+    FScopeLock Lock(&PendingMutex);
+    for (const FControlCommand& Command : Commands)
+    {
+        AddLocked(Command);
+    }
+    ScheduleFlushLocked();
+}
+
+void FControlEventCoalescer::ScheduleFlushLocked()
+{
+    const bool bFull = Pending.Num() >= MaxBatchSize;
+    if (bFull ? bFullFlushQueued : bFlushScheduled)
+    {
+        return;
+    }
+
+    // Workers may outlive the subsystem's reference only until the reactor drains them
+    TWeakPtr<FControlEventCoalescer> WeakThis = AsShared();
+    auto FlushTask = [WeakThis]()
+    {
+        if (TSharedPtr<FControlEventCoalescer> Pinned = WeakThis.Pin())
+        {
+            Pinned->Flush();
+        }
+    };
+
+    if (bFull)
+    {
+        bFullFlushQueued = true;
+        Reactor->QueueWork(MoveTemp(FlushTask), EQueuedWorkPriority::High);
+    }
+    else
+    {
+        bFlushScheduled = true;
+        Reactor->QueueWorkAfter(FlushInterval, MoveTemp(FlushTask), EQueuedWorkPriority::High);
+    }
+}
+
+void FControlEventCoalescer::AddLocked(const FControlCommand& Command)
+{
+    // Rejected submissions have no ID and nothing to collapse with
+    if (!Command.CommandId.IsEmpty())
+    {
+        if (const int32* Index = PendingIndex.Find(Command.CommandId))
+        {
+            Pending[*Index] = Command;
+            ++Collapsed;
+            return;
+        }
+        PendingIndex.Add(Command.CommandId, Pending.Num());
+    }
+    Pending.Add(Command);
+}
+
+void FControlEventCoalescer::Flush()
+{
+    FScopeLock FlushLock(&FlushMutex);
+
+    TArray<FControlCommand> Batch;
+    {
+        FScopeLock Lock(&PendingMutex);
+        Batch = MoveTemp(Pending);
+        Pending.Reset();
+        PendingIndex.Reset();
+        bFlushScheduled = false;
+        bFullFlushQueued = false;
+    }
+
+    for (int32 Start = 0; Start < Batch.Num(); Start += MaxBatchSize)
+    {
+        Journal->PublishCommands(TConstArrayView<FControlCommand>(Batch).Mid(Start, MaxBatchSize));
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Models/ControlModels.h"
+
+class FControlEventJournal;
+class FSocketReactor;
+
+/**
+ * Gathers command status changes between flushes and publishes them to the
+ * journal together, so a burst costs each client one frame instead of one
+ * per transition. A command that changes status several times before a
+ * flush is reported once, with its latest status. Adding only buffers:
+ * serialization and fan-out run on the reactor's worker pool, FlushInterval
+ * seconds after the first buffered change, or as soon as a batch fills to
+ * MaxBatchSize. The game thread never publishes.
+ */
+class FControlEventCoalescer : public TSharedFromThis<FControlEventCoalescer>
+{
+public:
+    FControlEventCoalescer(TSharedRef<FControlEventJournal> InJournal, TSharedRef<FSocketReactor> InReactor,
+        float InFlushInterval, int32 InMaxBatchSize);
+    ~FControlEventCoalescer();
+
+    /** Buffer a command's current state (any thread) */
+    void Add(const FControlCommand& Command);
+    void Add(const TArray<FControlCommand>& Commands);
+
+    /** Publish everything buffered now, on the calling thread (shutdown, tests) */
+    void Flush();
+
+    /** Transitions dropped because a later one for the same command superseded them */
+    int64 GetCollapsed() const { return Collapsed.Load(); }
+
+private:
+    /** Buffer one command; caller holds PendingMutex */
+    void AddLocked(const FControlCommand& Command);
+
+    /** Queue a worker flush now if the batch is full, else once per interval; caller holds PendingMutex */
+    void ScheduleFlushLocked();
+
+    TSharedRef<FControlEventJournal> Journal;
+    TSharedRef<FSocketReactor> Reactor;
+    float FlushInterval;
+    int32 MaxBatchSize;
+
+    /** Buffered commands in first-seen order, and their index by command ID */
+    TArray<FControlCommand> Pending;
+    TMap<FString, int32> PendingIndex;
+    /** A flush is queued for the buffered commands, at the interval or (bFullFlushQueued) at once */
+    bool bFlushScheduled = false;
+    bool bFullFlushQueued = false;
+    FCriticalSection PendingMutex;
+
+    /** Held across a whole flush, so batches reach the journal in the order they were cut */
+    FCriticalSection FlushMutex;
+
+    TAtomic<int64> Collapsed { 0 };
+};
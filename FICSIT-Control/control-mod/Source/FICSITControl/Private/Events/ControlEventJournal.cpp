@@ -0,0 +1,210 @@
+#include "ControlEventJournal.h"
+#include "ControlEventCbor.h"
+#include "Models/ControlModels.h"
+
+// COMMAND_BATCH framing around the comma-separated COMMAND_STATUS objects
+static constexpr FAnsiStringView BatchJsonSuffix = ANSITEXTVIEW("]}");
+
+static void AppendAnsi(TArray<uint8>& Out, FAnsiStringView Text)
+{
+    Out.Append(reinterpret_cast<const uint8*>(Text.GetData()), Text.Len());
+}
+
+static void AppendBatchJsonPrefix(TArray<uint8>& Out, uint64 Seq)
+{
+    TAnsiStringBuilder<64> Prefix;
+    Prefix << "{\"event\":\"COMMAND_BATCH\",\"seq\":" << Seq << ",\"commands\":[";
+    AppendAnsi(Out, Prefix.ToView());
+}
+
+void FControlEvent::BuildSubset(const TBitArray<>& Keep, bool bCbor, TArray<uint8>& Out) const
+{
+    int32 NumKept = 0;
+    for (int32 i = 0; i < Parts.Num(); ++i)
+    {
+        NumKept += Keep.IsValidIndex(i) && Keep[i] ? 1 : 0;
+    }
+
+    if (bCbor)
+    {
+        FControlEventCbor::BeginBatch(Out, NumKept, Seq);
+    }
+    else
+    {
+        AppendBatchJsonPrefix(Out, Seq);
+    }
+
+    bool bFirst = true;
+    for (int32 i = 0; i < Parts.Num(); ++i)
+    {
+        if (!Keep.IsValidIndex(i) || !Keep[i])
+        {
+            continue;
+        }
+
+        const FPart& Part = Parts[i];
+        if (bCbor)
+        {
+            Out.Append(Cbor.GetData() + Part.CborOffset, Part.CborLength);
+            continue;
+        }
+        if (!bFirst)
+        {
+            Out.Add(',');
+        }
+        Out.Append(Json.GetData() + Part.JsonOffset, Part.JsonLength);
+        bFirst = false;
+    }
+
+    if (bCbor)
+    {
+        FControlEventCbor::EndBatch(Out, TimestampMs);
+    }
+    else
+    {
+        AppendAnsi(Out, BatchJsonSuffix);
+    }
+}
+
+FControlEventJournal::FControlEventJournal(int32 InCapacity)
+{
+    Slots.SetNum(FMath::Max(InCapacity, 1));
+}
+
+FControlEventTopic FControlEventTopic::FromCommand(const FControlCommand& Command)
+{
+    FControlEventTopic Topic;
+    Topic.CommandType = Command.Type;
+    Topic.CommandId = Command.CommandId;
+    Topic.Issuer = Command.Issuer;
+    Topic.StreamId = Command.StreamId;
+
+    // Machine commands (recipe, overclock) name their target machineId
+    if (Command.Payload.IsValid() &&
+        !Command.Payload->TryGetStringField(TEXT("buildingId"), Topic.BuildingId))
+    {
+        Command.Payload->TryGetStringField(TEXT("machineId"), Topic.BuildingId);
+    }
+    return Topic;
+}
+
+void FControlEventJournal::Publish(const TSharedRef<FJsonObject>& Json, TArray<FControlEventTopic> Topics)
+{
+    TSharedRef<FControlEvent> Event = MakeShared<FControlEvent>();
+    Event->TimestampMs = static_cast<int64>((FDateTime::UtcNow() - FDateTime(1970, 1, 1)).GetTotalMilliseconds());
+    Event->Topics = MoveTemp(Topics);
+
+    // The number is part of the payload, so a single event is serialized under
+    // the lock. Publishers already take turns through the coalescer.
+    FScopeLock Lock(&Mutex);
+    Event->Seq = NextSeq++;
+    Json->SetNumberField(TEXT("seq"), static_cast<double>(Event->Seq));
+
+    const FTCHARToUTF8 Utf8(*JsonToString(Json));
+    Event->Json.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+    if (bEncodeCbor)
+    {
+        FControlEventCbor::Encode(*Json, Event->Cbor, Event->TimestampMs);
+    }
+
+    Slots[Event->Seq % Slots.Num()] = Event;
+    OnPublished.Broadcast(Event);
+}
+
+void FControlEventJournal::PublishCommands(TConstArrayView<FControlCommand> Commands)
+{
+    if (Commands.Num() == 0) return;
+
+    if (Commands.Num() == 1)
+    {
+        Publish(Commands[0].ToEventJson(), { FControlEventTopic::FromCommand(Commands[0]) });
+        return;
+    }
+
+    // Serialize each command on its own outside the lock, recording where each
+    // one lands so per-client subsets can be spliced later. Only the framing,
+    // which carries the number, is written under the lock.
+    TSharedRef<FControlEvent> Event = MakeShared<FControlEvent>();
+    Event->TimestampMs = static_cast<int64>((FDateTime::UtcNow() - FDateTime(1970, 1, 1)).GetTotalMilliseconds());
+    Event->Topics.Reserve(Commands.Num());
+    Event->Parts.Reserve(Commands.Num());
+
+    TArray<uint8> JsonBody;
+    TArray<uint8> CborBody;
+    for (const FControlCommand& Command : Commands)
+    {
+        const TSharedRef<FJsonObject> Json = Command.ToEventJson();
+        FControlEvent::FPart& Part = Event->Parts.AddDefaulted_GetRef();
+
+        if (Event->Parts.Num() > 1)
+        {
+            JsonBody.Add(',');
+        }
+        const FTCHARToUTF8 Utf8(*JsonToString(Json));
+        Part.JsonOffset = JsonBody.Num();
+        Part.JsonLength = Utf8.Length();
+        JsonBody.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+
+        if (bEncodeCbor)
+        {
+            Part.CborOffset = CborBody.Num();
+            FControlEventCbor::Encode(*Json, CborBody);
+            Part.CborLength = CborBody.Num() - Part.CborOffset;
+        }
+
+        Event->Topics.Add(FControlEventTopic::FromCommand(Command));
+    }
+
+    FScopeLock Lock(&Mutex);
+    Event->Seq = NextSeq++;
+
+    AppendBatchJsonPrefix(Event->Json, Event->Seq);
+    const int32 JsonPrefixLength = Event->Json.Num();
+    Event->Json.Append(JsonBody);
+    AppendAnsi(Event->Json, BatchJsonSuffix);
+
+    int32 CborPrefixLength = 0;
+    if (bEncodeCbor)
+    {
+        FControlEventCbor::BeginBatch(Event->Cbor, Commands.Num(), Event->Seq);
+        CborPrefixLength = Event->Cbor.Num();
+        Event->Cbor.Append(CborBody);
+        FControlEventCbor::EndBatch(Event->Cbor, Event->TimestampMs);
+    }
+
+    for (FControlEvent::FPart& Part : Event->Parts)
+    {
+        Part.JsonOffset += JsonPrefixLength;
+        Part.CborOffset += CborPrefixLength;
+    }
+
+    Slots[Event->Seq % Slots.Num()] = Event;
+    OnPublished.Broadcast(Event);
+}
+
+void FControlEventJournal::Attach(uint64 AfterSeq,
+    TFunctionRef<void(const TArray<TSharedRef<const FControlEvent>>&, bool)> OnAttach)
+{
+    FScopeLock Lock(&Mutex);
+
+    // Anything at or past the head means "live events only"
+    AfterSeq = FMath::Min(AfterSeq, NextSeq - 1);
+
+    const uint64 Capacity = Slots.Num();
+    const uint64 OldestRetained = NextSeq > Capacity ? NextSeq - Capacity : 1;
+    const uint64 First = FMath::Max(AfterSeq + 1, OldestRetained);
+
+    TArray<TSharedRef<const FControlEvent>> Missed;
+    for (uint64 Seq = First; Seq < NextSeq; ++Seq)
+    {
+        Missed.Add(Slots[Seq % Capacity].ToSharedRef());
+    }
+
+    OnAttach(Missed, AfterSeq + 1 < OldestRetained);
+}
+
+uint64 FControlEventJournal::GetLastSeq() const
+{
+    FScopeLock Lock(&Mutex);
+    return NextSeq - 1;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+
+struct FControlCommand;
+
+/** What an event is about, for routing it to subscribers; one per command it reports */
+struct FControlEventTopic
+{
+    FString CommandType;
+    FString CommandId;
+    /** Fingerprint of the token the command was submitted with */
+    FString Issuer;
+    /** Building or machine the command targets, empty if none */
+    FString BuildingId;
+    /** WebSocket connection that submitted the command, 0 if none */
+    uint64 StreamId = 0;
+
+    static FControlEventTopic FromCommand(const FControlCommand& Command);
+};
+
+/** One outbound event, serialized once and shared by every stream that sends it */
+struct FControlEvent
+{
+    /** Position in the journal, starting at 1; also sent as the "seq" field */
+    uint64 Seq = 0;
+
+    /** Compact JSON, UTF-8 encoded */
+    TArray<uint8> Json;
+
+    /** Integer-keyed CBOR for binary clients; empty unless the journal encodes it */
+    TArray<uint8> Cbor;
+
+    /** Publish time, Unix milliseconds */
+    int64 TimestampMs = 0;
+
+    /** Commands the event reports on; empty for events that concern every client */
+    TArray<FControlEventTopic> Topics;
+
+    /** Where one command of a COMMAND_BATCH sits in Json and Cbor */
+    struct FPart
+    {
+        int32 JsonOffset = 0;
+        int32 JsonLength = 0;
+        int32 CborOffset = 0;
+        int32 CborLength = 0;
+    };
+
+    /** For COMMAND_BATCH events: one entry per element of Topics, in order */
+    TArray<FPart> Parts;
+
+    /** True if a subset of the commands can be spliced out with BuildSubset */
+    bool CanSplit() const { return Parts.Num() > 1 && Parts.Num() == Topics.Num(); }
+
+    /**
+     * Assemble a COMMAND_BATCH holding only the commands whose bit is set in
+     * Keep, by copying their serialized bytes; nothing is re-encoded.
+     */
+    void BuildSubset(const TBitArray<>& Keep, bool bCbor, TArray<uint8>& Out) const;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnControlEventPublished, const TSharedRef<const FControlEvent>& /* Event */);
+
+/**
+ * Numbered log of the most recent outbound events.
+ * Every event is serialized once on publish, with its number as "seq", and
+ * handed to all streams as the same bytes; clients that reconnect resume from
+ * the last number they saw.
+ */
+class FControlEventJournal
+{
+public:
+    explicit FControlEventJournal(int32 InCapacity = 1024);
+
+    /** Number, serialize and retain an event, then broadcast it (any thread); adds "seq" to Json */
+    void Publish(const TSharedRef<FJsonObject>& Json, TArray<FControlEventTopic> Topics = {});
+
+    /**
+     * Publish the status of several commands: one COMMAND_STATUS for a single
+     * command, otherwise one COMMAND_BATCH whose commands can be split per client.
+     */
+    void PublishCommands(TConstArrayView<FControlCommand> Commands);
+
+    /**
+     * Run OnAttach under the journal lock with every retained event after
+     * AfterSeq. A stream registered inside OnAttach receives each later event
+     * exactly once and in order. Pass MAX_uint64 to skip the replay. bGap is
+     * set if events after AfterSeq were already dropped.
+     */
+    void Attach(uint64 AfterSeq,
+        TFunctionRef<void(const TArray<TSharedRef<const FControlEvent>>& /* Missed */, bool /* bGap */)> OnAttach);
+
+    /** Also encode every event as CBOR (set before publishing starts) */
+    void SetEncodeCbor(bool bInEncodeCbor) { bEncodeCbor = bInEncodeCbor; }
+
+    /** Number of the newest event, 0 if none yet */
+    uint64 GetLastSeq() const;
+
+    /** Fired under the journal lock, strictly in sequence order */
+    FOnControlEventPublished OnPublished;
+
+private:
+    /** Ring of retained events; Seq N lives at N % Capacity */
+    TArray<TSharedPtr<const FControlEvent>> Slots;
+    uint64 NextSeq = 1;
+    bool bEncodeCbor = false;
+
+    mutable FCriticalSection Mutex;
+};
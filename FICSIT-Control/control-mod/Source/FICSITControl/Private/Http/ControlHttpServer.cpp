@@ -1,12 +1,23 @@
 #include "ControlHttpServer.h"
+#include "HttpConnection.h"
+#include "HttpRequestParser.h"
+#include "HttpResponseWriter.h"
+#include "Net/SocketReactor.h"
+#include "Events/ControlEventJournal.h"
 #include "Interfaces/IPv4/IPv4Endpoint.h"
-#include "Misc/ScopeLock.h"
-#include "Async/Async.h"
+#include "Hash/CityHash.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogControlHttp, Log, All);
 
+// Longest a client may hold GET /control/v1/commands/:id?wait= open
+static constexpr double MaxCommandWaitSeconds = 30.0;
+
+// How long a shed client is asked to back off
+static constexpr FAnsiStringView RetryAfterHeader = "Retry-After: 1\r\n";
+
 FControlHttpServer::FControlHttpServer()
 {
+    SetCapabilities(FControlCapabilities());
 }
 
 FControlHttpServer::~FControlHttpServer()
@@ -14,24 +25,20 @@ FControlHttpServer::~FControlHttpServer()
     Stop();
 }
 
-bool FControlHttpServer::Start(int32 Port)
+bool FControlHttpServer::Start(int32 Port, TSharedRef<FSocketReactor> InReactor)
 {
     if (bRunning) return true;
 
-    FIPv4Endpoint Endpoint(FIPv4Address::Any, Port);
-
-    Listener = MakeUnique<FTcpListener>(
-        Endpoint,
-        FTimespan::FromSeconds(1.0),
-        false /* bReusable */
-    );
+    Reactor = InReactor;
 
-    Listener->OnConnectionAccepted().BindRaw(this, &FControlHttpServer::HandleConnection);
+    FIPv4Endpoint Endpoint(FIPv4Address::Any, Port);
+    ListenerId = Reactor->AddListener(Endpoint, TEXT("FICSITControl HTTP"),
+        FSocketReactor::FOnAccepted::CreateRaw(this, &FControlHttpServer::HandleConnection));
 
-    if (!Listener->Init())
+    if (ListenerId == INDEX_NONE)
     {
         UE_LOG(LogControlHttp, Error, TEXT("Failed to initialize TCP listener on port %d"), Port);
-        Listener.Reset();
+        Reactor.Reset();
         return false;
     }
 
@@ -40,264 +47,507 @@ bool FControlHttpServer::Start(int32 Port)
     return true;
 }
 
+bool FControlHttpServer::StartLocal(const FString& Path, int32 FileMode)
+{
+    if (!bRunning || !Reactor.IsValid()) return false;
+
+    LocalListenerId = Reactor->AddLocalListener(Path, FileMode, TEXT("FICSITControl HTTP (local)"),
+        FSocketReactor::FOnAccepted::CreateRaw(this, &FControlHttpServer::HandleConnection));
+
+    if (LocalListenerId == INDEX_NONE)
+    {
+        UE_LOG(LogControlHttp, Error, TEXT("Failed to initialize local listener on %s"), *Path);
+        return false;
+    }
+
+    UE_LOG(LogControlHttp, Log, TEXT("HTTP server listening on %s"), *Path);
+    return true;
+}
+
 void FControlHttpServer::Stop()
 {
     bRunning = false;
-    if (Listener.IsValid())
+    if (Reactor.IsValid())
     {
-        Listener.Reset();
+        // Keep the reactor reference: in-flight workers may still wake it
+        Reactor->RemoveListener(ListenerId);
+        Reactor->RemoveListener(LocalListenerId);
+        ListenerId = INDEX_NONE;
+        LocalListenerId = INDEX_NONE;
     }
     UE_LOG(LogControlHttp, Log, TEXT("HTTP server stopped"));
 }
 
-bool FControlHttpServer::HandleConnection(FSocket* ClientSocket, const FIPv4Endpoint& Endpoint)
+TSharedPtr<IReactorConnection> FControlHttpServer::HandleConnection(FSocket* ClientSocket)
 {
     if (!bRunning || !ClientSocket)
     {
-        if (ClientSocket)
-        {
-            ClientSocket->Close();
-            ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(ClientSocket);
-        }
-        return false;
+        return nullptr;
     }
 
-    // Process request asynchronously to avoid blocking the listener
-    Async(EAsyncExecution::ThreadPool, [this, ClientSocket]()
+    // Over the connection cap: best-effort 503 on the fresh socket, then drop it
+    if (NumConnections.Load() >= MaxConnections)
     {
-        ProcessRequest(ClientSocket);
-        ClientSocket->Close();
-        ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(ClientSocket);
-    });
+        static const ANSICHAR Busy[] =
+            "HTTP/1.1 503 Service Unavailable\r\n"
+            "Access-Control-Allow-Origin: *\r\n"
+            "Retry-After: 1\r\n"
+            "Connection: close\r\n"
+            "Content-Type: application/json\r\n"
+            "Content-Length: 23\r\n"
+            "\r\n"
+            "{\"error\":\"Server busy\"}";
+        int32 BytesSent = 0;
+        FSocketReactor::SendSome(ClientSocket, reinterpret_cast<const uint8*>(Busy), sizeof(Busy) - 1, BytesSent);
+        UE_LOG(LogControlHttp, Verbose, TEXT("Connection refused: %d open"), NumConnections.Load());
+        ++RefusedConnections;
+        return nullptr;
+    }
 
-    return true;
+    ++NumConnections;
+    return MakeShared<FHttpConnection>(ClientSocket, *this);
 }
 
-void FControlHttpServer::ProcessRequest(FSocket* ClientSocket)
+void FControlHttpServer::DispatchRequest(TSharedRef<FHttpConnection> Connection, TSharedRef<FHttpRequest> Request)
 {
-    // Read data with a timeout
-    ClientSocket->SetNonBlocking(false);
-    ClientSocket->SetRecvErr();
-
-    // Wait for data (up to 5 seconds)
-    if (!ClientSocket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromSeconds(5.0)))
+    // Shed load before queueing: bulk traffic only gets half of the budget
+    const bool bBulk = IsBulkRequest(*Request);
+    const int32 Limit = bBulk ? MaxInFlightRequests / 2 : MaxInFlightRequests;
+    if (InFlightRequests.Load() >= Limit)
     {
+        ++ShedRequests;
+        Connection->IncrementRequestCount();
+        ApplyKeepAlive(*Connection, *Request);
+        SendServiceUnavailable(*Connection, TEXT("Server busy"));
+        Connection->CompleteRequest();
         return;
     }
 
-    // Read the request
-    TArray<uint8> Buffer;
-    Buffer.SetNumUninitialized(65536);
-    int32 BytesRead = 0;
-    if (!ClientSocket->Recv(Buffer.GetData(), Buffer.Num(), BytesRead))
+    // Only complete requests reach the workers; the reactor never blocks on a socket
+    ++InFlightRequests;
+    Reactor->QueueWork([this, Connection, Request]()
     {
-        return;
-    }
+        const bool bAnswered = ProcessRequest(*Connection, *Request);
+        --InFlightRequests;
 
-    if (BytesRead <= 0) return;
+        // A parked request is completed later by whoever answers it; what it
+        // wrote so far (stream headers, replayed events) still goes out now
+        if (bAnswered)
+        {
+            Connection->CompleteRequest();
+        }
+        else
+        {
+            WakeReactor();
+        }
+    }, bBulk ? EQueuedWorkPriority::Low : EQueuedWorkPriority::Normal);
+}
 
-    FString RawRequest = FString(BytesRead, UTF8_TO_TCHAR(reinterpret_cast<const char*>(Buffer.GetData())));
+void FControlHttpServer::DispatchParseError(TSharedRef<FHttpConnection> Connection, int32 StatusCode)
+{
+    Reactor->QueueWork([this, Connection, StatusCode]()
+    {
+        Connection->IncrementRequestCount();
+        Connection->SetKeepAlive(false);
+        const TCHAR* Message = TEXT("Bad Request");
+        switch (StatusCode)
+        {
+        case 413: Message = TEXT("Request body too large"); break;
+        case 431: Message = TEXT("Request headers too large"); break;
+        case 501: Message = TEXT("Unsupported transfer encoding"); break;
+        }
+        SendJsonError(*Connection, StatusCode, Message);
+        Connection->CompleteRequest();
+    });
+}
 
-    FString Method, Path;
-    TMap<FString, FString> Headers;
-    FString Body;
+void FControlHttpServer::WakeReactor()
+{
+    if (Reactor.IsValid())
+    {
+        Reactor->Wake();
+    }
+}
 
-    if (!ParseHttpRequest(RawRequest, Method, Path, Headers, Body))
+void FControlHttpServer::BroadcastEvent(const FControlEvent& Event)
+{
+    TArray<TSharedPtr<FHttpConnection>> Streams;
     {
-        SendJsonError(ClientSocket, 400, TEXT("Bad Request"));
-        return;
+        FScopeLock Lock(&EventStreamsMutex);
+        EventStreams.RemoveAll([&Streams](const TWeakPtr<FHttpConnection>& Weak)
+        {
+            TSharedPtr<FHttpConnection> Conn = Weak.Pin();
+            if (!Conn.IsValid()) return true;
+            Streams.Add(MoveTemp(Conn));
+            return false;
+        });
     }
 
-    UE_LOG(LogControlHttp, Verbose, TEXT("%s %s"), *Method, *Path);
+    if (Streams.Num() == 0) return;
+
+    TArray<uint8> Message;
+    AppendSseEvent(Message, Event);
+    for (const TSharedPtr<FHttpConnection>& Conn : Streams)
+    {
+        if (!Conn->WriteEvent(Message.GetData(), Message.Num(), MaxStreamQueuedBytes))
+        {
+            // Closed by the reactor; its park handler removes it from EventStreams
+            ++SlowStreamEvictions;
+        }
+    }
+    WakeReactor();
+}
+
+void FControlHttpServer::AppendSseEvent(TArray<uint8>& Out, const FControlEvent& Event)
+{
+    // Compact JSON has no newlines, so it fits a single data line
+    FHttpResponseWriter::AppendAscii(Out, "id: ");
+    FHttpResponseWriter::AppendDecimal(Out, static_cast<int64>(Event.Seq));
+    FHttpResponseWriter::AppendAscii(Out, "\ndata: ");
+    Out.Append(Event.Json);
+    FHttpResponseWriter::AppendAscii(Out, "\n\n");
+}
+
+bool FControlHttpServer::ProcessRequest(FHttpConnection& Connection, const FHttpRequest& Request)
+{
+    Connection.IncrementRequestCount();
+
+    const FUtf8StringView Method = Request.GetMethod();
+    const FUtf8StringView Path = Request.GetPath();
+
+    UE_LOG(LogControlHttp, Verbose, TEXT("%s %s"),
+        *FHttpRequest::ToString(Method), *FHttpRequest::ToString(Path));
+
+    ApplyKeepAlive(Connection, Request);
 
     // CORS preflight
-    if (Method == TEXT("OPTIONS"))
+    if (FHttpRequest::Equals(Method, UTF8TEXTVIEW("OPTIONS")))
     {
-        SendResponse(ClientSocket, 204, TEXT("No Content"), TEXT(""), TEXT(""));
-        return;
+        SendResponse(Connection, 204, "No Content", FAnsiStringView(), FString());
+        return true;
     }
 
     // Route: GET /control/v1/capabilities
-    if (Method == TEXT("GET") && Path == TEXT("/control/v1/capabilities"))
+    if (FHttpRequest::Equals(Method, UTF8TEXTVIEW("GET")) &&
+        FHttpRequest::Equals(Path, UTF8TEXTVIEW("/control/v1/capabilities")))
     {
-        HandleCapabilities(ClientSocket);
-        return;
+        HandleCapabilities(Connection, Request);
+        return true;
+    }
+
+    // Route: GET /control/v1/stats
+    if (FHttpRequest::Equals(Method, UTF8TEXTVIEW("GET")) &&
+        FHttpRequest::Equals(Path, UTF8TEXTVIEW("/control/v1/stats")))
+    {
+        HandleStats(Connection, Request);
+        return true;
     }
 
     // Route: POST /control/v1/commands
-    if (Method == TEXT("POST") && Path == TEXT("/control/v1/commands"))
+    if (FHttpRequest::Equals(Method, UTF8TEXTVIEW("POST")) &&
+        FHttpRequest::Equals(Path, UTF8TEXTVIEW("/control/v1/commands")))
     {
-        HandlePostCommand(ClientSocket, Headers, Body);
-        return;
+        HandlePostCommand(Connection, Request);
+        return true;
+    }
+
+    // Route: GET /control/v1/events
+    if (FHttpRequest::Equals(Method, UTF8TEXTVIEW("GET")) &&
+        FHttpRequest::Equals(Path, UTF8TEXTVIEW("/control/v1/events")))
+    {
+        return HandleEventStream(Connection, Request);
+    }
+
+    // Route: POST /control/v1/commands/batch
+    if (FHttpRequest::Equals(Method, UTF8TEXTVIEW("POST")) &&
+        FHttpRequest::Equals(Path, UTF8TEXTVIEW("/control/v1/commands/batch")))
+    {
+        HandlePostBatch(Connection, Request);
+        return true;
     }
 
     // Route: GET /control/v1/commands/:id
-    if (Method == TEXT("GET") && Path.StartsWith(TEXT("/control/v1/commands/")))
+    const FUtf8StringView CommandPrefix = UTF8TEXTVIEW("/control/v1/commands/");
+    if (FHttpRequest::Equals(Method, UTF8TEXTVIEW("GET")) &&
+        FHttpRequest::Equals(Path.Left(CommandPrefix.Len()), CommandPrefix))
     {
-        FString CommandId = Path.Mid(21); // Length of "/control/v1/commands/"
-        HandleGetCommand(ClientSocket, Headers, CommandId);
-        return;
+        FString CommandId = FHttpRequest::ToString(Path.RightChop(CommandPrefix.Len()));
+        return HandleGetCommand(Connection, Request, CommandId);
     }
 
-    SendJsonError(ClientSocket, 404, TEXT("Not found"));
+    SendJsonError(Connection, 404, TEXT("Not found"));
+    return true;
 }
 
-bool FControlHttpServer::ParseHttpRequest(const FString& RawRequest,
-    FString& OutMethod, FString& OutPath,
-    TMap<FString, FString>& OutHeaders, FString& OutBody)
+void FControlHttpServer::ApplyKeepAlive(FHttpConnection& Connection, const FHttpRequest& Request)
 {
-    // Split header section from body at \r\n\r\n
-    int32 HeaderEnd;
-    if (!RawRequest.FindChar('\r', HeaderEnd))
+    // HTTP/1.1 defaults to persistent connections, HTTP/1.0 must opt in
+    const FUtf8StringView ConnectionHeader = Request.FindHeader(UTF8TEXTVIEW("connection"));
+    bool bKeepAlive = !FHttpRequest::Equals(Request.GetVersion(), UTF8TEXTVIEW("HTTP/1.0"));
+    if (FHttpRequest::ContainsIgnoreCase(ConnectionHeader, UTF8TEXTVIEW("close")))
     {
-        // Try to at least parse the first line
+        bKeepAlive = false;
     }
+    else if (FHttpRequest::ContainsIgnoreCase(ConnectionHeader, UTF8TEXTVIEW("keep-alive")))
+    {
+        bKeepAlive = true;
+    }
+    if (!bRunning || Connection.GetRequestCount() >= MaxKeepAliveRequests)
+    {
+        bKeepAlive = false;
+    }
+    Connection.SetKeepAlive(bKeepAlive);
+}
 
-    FString HeaderSection;
-    int32 BodyStart = INDEX_NONE;
+bool FControlHttpServer::IsBulkRequest(const FHttpRequest& Request)
+{
+    return FHttpRequest::Equals(Request.GetPath(), UTF8TEXTVIEW("/control/v1/commands/batch")) ||
+        FHttpRequest::EqualsIgnoreCase(Request.FindHeader(UTF8TEXTVIEW("x-control-priority")), UTF8TEXTVIEW("bulk"));
+}
 
-    int32 SepIndex = RawRequest.Find(TEXT("\r\n\r\n"));
-    if (SepIndex != INDEX_NONE)
+void FControlHttpServer::WriteResponseHeaders(FHttpResponseWriter& Writer, FHttpConnection& Connection,
+    FAnsiStringView ContentType, FAnsiStringView ExtraHeaders) const
+{
+    if (Connection.ShouldKeepAlive())
     {
-        HeaderSection = RawRequest.Left(SepIndex);
-        BodyStart = SepIndex + 4;
-        OutBody = RawRequest.Mid(BodyStart);
+        Writer.AddHeader("Connection", "keep-alive");
+        TArray<uint8>& Out = Writer.GetBuffer();
+        FHttpResponseWriter::AppendAscii(Out, "Keep-Alive: timeout=");
+        FHttpResponseWriter::AppendDecimal(Out, FMath::CeilToInt(KeepAliveTimeout));
+        FHttpResponseWriter::AppendAscii(Out, ", max=");
+        FHttpResponseWriter::AppendDecimal(Out, MaxKeepAliveRequests - Connection.GetRequestCount());
+        FHttpResponseWriter::AppendAscii(Out, "\r\n");
     }
     else
     {
-        HeaderSection = RawRequest;
-        OutBody = TEXT("");
+        Writer.AddHeader("Connection", "close");
     }
 
-    // Parse request line
-    TArray<FString> Lines;
-    HeaderSection.ParseIntoArray(Lines, TEXT("\r\n"));
+    if (!ContentType.IsEmpty())
+    {
+        Writer.AddHeader("Content-Type", ContentType);
+    }
 
-    if (Lines.Num() == 0) return false;
+    Writer.AddRawHeaders(ExtraHeaders);
+}
 
-    TArray<FString> RequestParts;
-    Lines[0].ParseIntoArrayWS(RequestParts);
+void FControlHttpServer::SendResponse(FHttpConnection& Connection, int32 StatusCode,
+    FAnsiStringView StatusText, FAnsiStringView ContentType, const FString& Body, FAnsiStringView ExtraHeaders)
+{
+    FHttpResponseWriter Writer(StatusCode, StatusText);
+    WriteResponseHeaders(Writer, Connection, ContentType, ExtraHeaders);
+    Writer.Finish(Body);
 
-    if (RequestParts.Num() < 2) return false;
+    // Headers and body leave in one buffer; the reactor flushes it as the socket drains
+    Connection.Write(MoveTemp(Writer.GetBuffer()));
+}
 
-    OutMethod = RequestParts[0].ToUpper();
-    OutPath = RequestParts[1];
+void FControlHttpServer::SendResponse(FHttpConnection& Connection, int32 StatusCode,
+    FAnsiStringView StatusText, FAnsiStringView ContentType, TArrayView<const uint8> Body, FAnsiStringView ExtraHeaders)
+{
+    FHttpResponseWriter Writer(StatusCode, StatusText);
+    WriteResponseHeaders(Writer, Connection, ContentType, ExtraHeaders);
+    Writer.Finish(Body);
+    Connection.Write(MoveTemp(Writer.GetBuffer()));
+}
 
-    // Strip query string from path for routing
-    int32 QueryIndex;
-    if (OutPath.FindChar('?', QueryIndex))
+void FControlHttpServer::SendJsonResponse(FHttpConnection& Connection, int32 StatusCode,
+    const TSharedRef<FJsonObject>& Json)
+{
+    FString JsonStr = JsonToString(Json);
+    FAnsiStringView StatusText;
+    switch (StatusCode)
     {
-        OutPath = OutPath.Left(QueryIndex);
+    case 200: StatusText = "OK"; break;
+    case 201: StatusText = "Created"; break;
+    case 202: StatusText = "Accepted"; break;
+    default:  StatusText = "OK"; break;
     }
 
-    // Parse headers
-    for (int32 i = 1; i < Lines.Num(); ++i)
+    SendResponse(Connection, StatusCode, StatusText, "application/json", JsonStr);
+}
+
+void FControlHttpServer::SendJsonError(FHttpConnection& Connection, int32 StatusCode,
+    const FString& ErrorMessage)
+{
+    auto ErrorJson = MakeShared<FJsonObject>();
+    ErrorJson->SetStringField(TEXT("error"), ErrorMessage);
+
+    FAnsiStringView StatusText;
+    switch (StatusCode)
     {
-        int32 ColonIndex;
-        if (Lines[i].FindChar(':', ColonIndex))
-        {
-            FString Key = Lines[i].Left(ColonIndex).TrimStartAndEnd();
-            FString Value = Lines[i].Mid(ColonIndex + 1).TrimStartAndEnd();
-            OutHeaders.Add(Key.ToLower(), Value);
-        }
+    case 400: StatusText = "Bad Request"; break;
+    case 401: StatusText = "Unauthorized"; break;
+    case 404: StatusText = "Not Found"; break;
+    case 413: StatusText = "Payload Too Large"; break;
+    case 429: StatusText = "Too Many Requests"; break;
+    case 431: StatusText = "Request Header Fields Too Large"; break;
+    case 500: StatusText = "Internal Server Error"; break;
+    case 501: StatusText = "Not Implemented"; break;
+    case 503: StatusText = "Service Unavailable"; break;
+    default:  StatusText = "Error"; break;
     }
 
-    return true;
+    SendResponse(Connection, StatusCode, StatusText, "application/json", JsonToString(ErrorJson));
 }
 
-void FControlHttpServer::SendResponse(FSocket* Socket, int32 StatusCode,
-    const FString& StatusText, const FString& ContentType, const FString& Body)
+void FControlHttpServer::SendServiceUnavailable(FHttpConnection& Connection, const FString& ErrorMessage)
 {
-    FString Response = FString::Printf(
-        TEXT("HTTP/1.1 %d %s\r\n"
-             "Access-Control-Allow-Origin: *\r\n"
-             "Access-Control-Allow-Headers: Content-Type, Authorization\r\n"
-             "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
-             "Connection: close\r\n"),
-        StatusCode, *StatusText
-    );
+    auto ErrorJson = MakeShared<FJsonObject>();
+    ErrorJson->SetStringField(TEXT("error"), ErrorMessage);
 
-    if (!ContentType.IsEmpty())
+    SendResponse(Connection, 503, "Service Unavailable", "application/json", JsonToString(ErrorJson),
+        RetryAfterHeader);
+}
+
+// -- Route Handlers --
+
+void FControlHttpServer::SetCapabilities(const FControlCapabilities& InCapabilities)
+{
+    // Serialize once; requests only copy these bytes
+    TSharedRef<FCachedDocument> Document = MakeShared<FCachedDocument>();
+    FHttpResponseWriter::AppendUtf8(Document->Body, JsonToString(InCapabilities.ToJson()));
+
+    const uint64 Hash = CityHash64(reinterpret_cast<const char*>(Document->Body.GetData()), Document->Body.Num());
+    TAnsiStringBuilder<24> Tag;
+    Tag.Appendf("\"%016llx\"", Hash);
+    FHttpResponseWriter::AppendAscii(Document->ETag, Tag.ToView());
+
+    FHttpResponseWriter::AppendAscii(Document->Headers, "ETag: ");
+    FHttpResponseWriter::AppendAscii(Document->Headers, Tag.ToView());
+    FHttpResponseWriter::AppendAscii(Document->Headers, "\r\nCache-Control: no-cache\r\n");
+
+    FScopeLock Lock(&CapabilitiesMutex);
+    Capabilities = InCapabilities;
+    CapabilitiesDocument = Document;
+}
+
+FControlCapabilities FControlHttpServer::GetCapabilities() const
+{
+    FScopeLock Lock(&CapabilitiesMutex);
+    return Capabilities;
+}
+
+void FControlHttpServer::HandleCapabilities(FHttpConnection& Connection, const FHttpRequest& Request)
+{
+    TSharedPtr<const FCachedDocument> Document;
     {
-        Response += FString::Printf(TEXT("Content-Type: %s\r\n"), *ContentType);
+        FScopeLock Lock(&CapabilitiesMutex);
+        Document = CapabilitiesDocument;
     }
 
-    FTCHARToUTF8 Utf8Body(*Body);
-    Response += FString::Printf(TEXT("Content-Length: %d\r\n"), Utf8Body.Length());
-    Response += TEXT("\r\n");
-
-    // Send headers
-    FTCHARToUTF8 Utf8Headers(*Response);
-    int32 BytesSent = 0;
-    Socket->Send(reinterpret_cast<const uint8*>(Utf8Headers.Get()), Utf8Headers.Length(), BytesSent);
+    const FAnsiStringView Headers(reinterpret_cast<const ANSICHAR*>(Document->Headers.GetData()), Document->Headers.Num());
 
-    // Send body
-    if (Utf8Body.Length() > 0)
+    if (MatchesETag(Request.FindHeader(UTF8TEXTVIEW("if-none-match")), Document->GetETag()))
     {
-        Socket->Send(reinterpret_cast<const uint8*>(Utf8Body.Get()), Utf8Body.Length(), BytesSent);
+        FHttpResponseWriter Writer(304, "Not Modified");
+        WriteResponseHeaders(Writer, Connection, FAnsiStringView(), Headers);
+        Writer.FinishStreaming();
+        Connection.Write(MoveTemp(Writer.GetBuffer()));
+        return;
     }
+
+    SendResponse(Connection, 200, "OK", "application/json", TArrayView<const uint8>(Document->Body), Headers);
 }
 
-void FControlHttpServer::SendJsonResponse(FSocket* Socket, int32 StatusCode,
-    const TSharedRef<FJsonObject>& Json)
+bool FControlHttpServer::MatchesETag(FUtf8StringView IfNoneMatch, FUtf8StringView ETag)
 {
-    FString JsonStr = JsonToString(Json);
-    FString StatusText;
-    switch (StatusCode)
+    // Comma-separated list of tags, "*", with weak comparison (W/ ignored)
+    while (!IfNoneMatch.IsEmpty())
     {
-    case 200: StatusText = TEXT("OK"); break;
-    case 201: StatusText = TEXT("Created"); break;
-    case 202: StatusText = TEXT("Accepted"); break;
-    default:  StatusText = TEXT("OK"); break;
-    }
+        int32 Comma = INDEX_NONE;
+        IfNoneMatch.FindChar(UTF8CHAR(','), Comma);
+        FUtf8StringView Candidate = Comma == INDEX_NONE ? IfNoneMatch : IfNoneMatch.Left(Comma);
+        IfNoneMatch = Comma == INDEX_NONE ? FUtf8StringView() : IfNoneMatch.RightChop(Comma + 1);
 
-    SendResponse(Socket, StatusCode, StatusText, TEXT("application/json"), JsonStr);
+        Candidate = Candidate.TrimStartAndEnd();
+        if (Candidate.StartsWith(UTF8TEXTVIEW("W/")))
+        {
+            Candidate.RightChopInline(2);
+        }
+        if (FHttpRequest::Equals(Candidate, UTF8TEXTVIEW("*")) || FHttpRequest::Equals(Candidate, ETag))
+        {
+            return true;
+        }
+    }
+    return false;
 }
 
-void FControlHttpServer::SendJsonError(FSocket* Socket, int32 StatusCode,
-    const FString& ErrorMessage)
+void FControlHttpServer::HandleStats(FHttpConnection& Connection, const FHttpRequest& Request)
 {
-    auto ErrorJson = MakeShared<FJsonObject>();
-    ErrorJson->SetStringField(TEXT("error"), ErrorMessage);
+    if (!IsAuthorized(Request))
+    {
+        SendJsonError(Connection, 401, TEXT("Unauthorized"));
+        return;
+    }
 
-    FString StatusText;
-    switch (StatusCode)
+    auto Root = MakeShared<FJsonObject>();
+
+    if (Reactor.IsValid())
+    {
+        const FReactorStats ReactorStats = Reactor->GetStats();
+        auto ReactorJson = MakeShared<FJsonObject>();
+        ReactorJson->SetNumberField(TEXT("connections"), ReactorStats.Connections);
+        ReactorJson->SetNumberField(TEXT("accepted"), static_cast<double>(ReactorStats.Accepted));
+        ReactorJson->SetNumberField(TEXT("refused"), static_cast<double>(ReactorStats.Refused));
+        ReactorJson->SetNumberField(TEXT("timedOut"), static_cast<double>(ReactorStats.TimedOut));
+        Root->SetObjectField(TEXT("reactor"), ReactorJson);
+    }
+
+    auto TimeoutsJson = MakeShared<FJsonObject>();
+    TimeoutsJson->SetNumberField(TEXT("idle"), static_cast<double>(Timeouts[static_cast<int32>(EHttpTimeout::Idle)].Load()));
+    TimeoutsJson->SetNumberField(TEXT("request"), static_cast<double>(Timeouts[static_cast<int32>(EHttpTimeout::Request)].Load()));
+    TimeoutsJson->SetNumberField(TEXT("write"), static_cast<double>(Timeouts[static_cast<int32>(EHttpTimeout::Write)].Load()));
+
+    int32 NumEventStreams = 0;
     {
-    case 400: StatusText = TEXT("Bad Request"); break;
-    case 401: StatusText = TEXT("Unauthorized"); break;
-    case 404: StatusText = TEXT("Not Found"); break;
-    case 429: StatusText = TEXT("Too Many Requests"); break;
-    case 500: StatusText = TEXT("Internal Server Error"); break;
-    default:  StatusText = TEXT("Error"); break;
+        FScopeLock Lock(&EventStreamsMutex);
+        NumEventStreams = EventStreams.Num();
     }
 
-    SendResponse(Socket, StatusCode, StatusText, TEXT("application/json"), JsonToString(ErrorJson));
+    auto Http = MakeShared<FJsonObject>();
+    Http->SetNumberField(TEXT("connections"), NumConnections.Load());
+    Http->SetNumberField(TEXT("inFlightRequests"), InFlightRequests.Load());
+    Http->SetNumberField(TEXT("eventStreams"), NumEventStreams);
+    Http->SetNumberField(TEXT("slowStreamEvictions"), static_cast<double>(SlowStreamEvictions.Load()));
+    Http->SetNumberField(TEXT("refusedConnections"), static_cast<double>(RefusedConnections.Load()));
+    Http->SetNumberField(TEXT("shedRequests"), static_cast<double>(ShedRequests.Load()));
+    Http->SetObjectField(TEXT("timeouts"), TimeoutsJson);
+    Root->SetObjectField(TEXT("http"), Http);
+
+    OnCollectStats.ExecuteIfBound(Root);
+
+    SendJsonResponse(Connection, 200, Root);
 }
 
-// -- Route Handlers --
+bool FControlHttpServer::IsAuthorized(const FHttpRequest& Request) const
+{
+    // Skip the conversion entirely when auth is disabled
+    if (!Auth.IsConfigured()) return true;
+    return Auth.ValidateAuthHeader(FHttpRequest::ToString(Request.FindHeader(UTF8TEXTVIEW("authorization"))));
+}
 
-void FControlHttpServer::HandleCapabilities(FSocket* Socket)
+FString FControlHttpServer::GetIssuer(const FHttpRequest& Request)
 {
-    SendJsonResponse(Socket, 200, Capabilities.ToJson());
+    const FString Header = FHttpRequest::ToString(Request.FindHeader(UTF8TEXTVIEW("authorization")));
+    return Header.StartsWith(TEXT("Bearer ")) ? FTokenAuth::Fingerprint(Header.Mid(7)) : FString();
 }
 
-void FControlHttpServer::HandlePostCommand(FSocket* Socket,
-    const TMap<FString, FString>& Headers, const FString& Body)
+void FControlHttpServer::HandlePostCommand(FHttpConnection& Connection, const FHttpRequest& Request)
 {
     // Auth check
-    const FString* AuthHeader = Headers.Find(TEXT("authorization"));
-    if (!Auth.ValidateAuthHeader(AuthHeader ? *AuthHeader : TEXT("")))
+    if (!IsAuthorized(Request))
     {
-        SendJsonError(Socket, 401, TEXT("Unauthorized"));
+        SendJsonError(Connection, 401, TEXT("Unauthorized"));
         return;
     }
 
     // Parse JSON body
     TSharedPtr<FJsonObject> JsonBody;
-    auto Reader = TJsonReaderFactory<>::Create(Body);
+    auto Reader = TJsonReaderFactory<>::Create(Request.GetBodyAsString());
     if (!FJsonSerializer::Deserialize(Reader, JsonBody) || !JsonBody.IsValid())
     {
-        SendJsonError(Socket, 400, TEXT("Invalid JSON"));
+        SendJsonError(Connection, 400, TEXT("Invalid JSON"));
         return;
     }
 
@@ -307,7 +557,7 @@ void FControlHttpServer::HandlePostCommand(FSocket* Socket,
     if (!JsonBody->TryGetStringField(TEXT("idempotencyKey"), IdempotencyKey) ||
         !JsonBody->TryGetStringField(TEXT("type"), Type))
     {
-        SendJsonError(Socket, 400, TEXT("Missing required fields: idempotencyKey, type"));
+        SendJsonError(Connection, 400, TEXT("Missing required fields: idempotencyKey, type"));
         return;
     }
 
@@ -322,44 +572,264 @@ void FControlHttpServer::HandlePostCommand(FSocket* Socket,
     // Delegate to command router
     if (OnCommandReceived.IsBound())
     {
-        FControlCommand Cmd = OnCommandReceived.Execute(Type, Payload);
+        FControlCommand Cmd = OnCommandReceived.Execute(Type, Payload, GetIssuer(Request));
+        if (Cmd.Rejection == EControlRejection::Overloaded)
+        {
+            SendServiceUnavailable(Connection, Cmd.Error);
+            return;
+        }
 
         // Set the idempotency key on the command
         Cmd.IdempotencyKey = IdempotencyKey;
 
-        SendJsonResponse(Socket, 202, Cmd.ToResponseJson());
+        SendJsonResponse(Connection, 202, Cmd.ToResponseJson());
     }
     else
     {
-        SendJsonError(Socket, 500, TEXT("Command router not available"));
+        SendJsonError(Connection, 500, TEXT("Command router not available"));
     }
 }
 
-void FControlHttpServer::HandleGetCommand(FSocket* Socket,
-    const TMap<FString, FString>& Headers, const FString& CommandId)
+void FControlHttpServer::HandlePostBatch(FHttpConnection& Connection, const FHttpRequest& Request)
 {
     // Auth check
-    const FString* AuthHeader = Headers.Find(TEXT("authorization"));
-    if (!Auth.ValidateAuthHeader(AuthHeader ? *AuthHeader : TEXT("")))
+    if (!IsAuthorized(Request))
     {
-        SendJsonError(Socket, 401, TEXT("Unauthorized"));
+        SendJsonError(Connection, 401, TEXT("Unauthorized"));
         return;
     }
 
-    if (OnCommandQuery.IsBound())
+    // Parse JSON body
+    TSharedPtr<FJsonObject> JsonBody;
+    auto Reader = TJsonReaderFactory<>::Create(Request.GetBodyAsString());
+    if (!FJsonSerializer::Deserialize(Reader, JsonBody) || !JsonBody.IsValid())
+    {
+        SendJsonError(Connection, 400, TEXT("Invalid JSON"));
+        return;
+    }
+
+    const TArray<TSharedPtr<FJsonValue>>* Items;
+    if (!JsonBody->TryGetArrayField(TEXT("commands"), Items) || Items->Num() == 0)
+    {
+        SendJsonError(Connection, 400, TEXT("Missing required field: commands"));
+        return;
+    }
+
+    if (Items->Num() > MaxBatchSize)
+    {
+        SendJsonError(Connection, 413, FString::Printf(TEXT("Batch exceeds %d commands"), MaxBatchSize));
+        return;
+    }
+
+    // Reject the whole batch if any entry is malformed, so indices stay meaningful
+    const FString Issuer = GetIssuer(Request);
+    TArray<FControlCommandRequest> Requests;
+    Requests.Reserve(Items->Num());
+    for (int32 i = 0; i < Items->Num(); ++i)
     {
-        TSharedPtr<FControlCommand> Cmd = OnCommandQuery.Execute(CommandId);
-        if (Cmd.IsValid())
+        const TSharedPtr<FJsonObject>* ItemObj;
+        FControlCommandRequest& Entry = Requests.AddDefaulted_GetRef();
+        Entry.Issuer = Issuer;
+        if (!(*Items)[i]->TryGetObject(ItemObj) ||
+            !(*ItemObj)->TryGetStringField(TEXT("idempotencyKey"), Entry.IdempotencyKey) ||
+            !(*ItemObj)->TryGetStringField(TEXT("type"), Entry.Type))
         {
-            SendJsonResponse(Socket, 200, Cmd->ToResponseJson());
+            SendJsonError(Connection, 400,
+                FString::Printf(TEXT("commands[%d]: missing required fields: idempotencyKey, type"), i));
+            return;
         }
-        else
+
+        const TSharedPtr<FJsonObject>* PayloadPtr;
+        if ((*ItemObj)->TryGetObjectField(TEXT("payload"), PayloadPtr))
         {
-            SendJsonError(Socket, 404, TEXT("Command not found"));
+            Entry.Payload = *PayloadPtr;
         }
     }
-    else
+
+    if (!OnBatchReceived.IsBound())
+    {
+        SendJsonError(Connection, 500, TEXT("Command router not available"));
+        return;
+    }
+
+    const TArray<FControlCommand> Commands = OnBatchReceived.Execute(Requests);
+
+    // Batches are admitted or refused as a whole
+    if (Commands.Num() > 0 && Commands[0].Rejection == EControlRejection::Overloaded)
     {
-        SendJsonError(Socket, 500, TEXT("Command router not available"));
+        SendServiceUnavailable(Connection, Commands[0].Error);
+        return;
     }
+
+    TArray<TSharedPtr<FJsonValue>> Results;
+    Results.Reserve(Commands.Num());
+    for (const FControlCommand& Cmd : Commands)
+    {
+        Results.Add(MakeShared<FJsonValueObject>(Cmd.ToResponseJson()));
+    }
+
+    auto Response = MakeShared<FJsonObject>();
+    Response->SetArrayField(TEXT("commands"), Results);
+    SendJsonResponse(Connection, 202, Response);
+}
+
+bool FControlHttpServer::HandleGetCommand(FHttpConnection& Connection,
+    const FHttpRequest& Request, const FString& CommandId)
+{
+    // Auth check
+    if (!IsAuthorized(Request))
+    {
+        SendJsonError(Connection, 401, TEXT("Unauthorized"));
+        return true;
+    }
+
+    if (!OnCommandQuery.IsBound())
+    {
+        SendJsonError(Connection, 500, TEXT("Command router not available"));
+        return true;
+    }
+
+    TSharedPtr<FControlCommand> Cmd = OnCommandQuery.Execute(CommandId);
+    if (!Cmd.IsValid())
+    {
+        SendJsonError(Connection, 404, TEXT("Command not found"));
+        return true;
+    }
+
+    // Long-poll: ?wait=<seconds> holds the response until the command settles
+    double WaitSeconds = 0.0;
+    FUtf8StringView WaitParam;
+    if (Request.FindQueryParam(UTF8TEXTVIEW("wait"), WaitParam))
+    {
+        WaitSeconds = FMath::Clamp(FCString::Atod(*FHttpRequest::ToString(WaitParam)), 0.0, MaxCommandWaitSeconds);
+    }
+
+    if (WaitSeconds <= 0.0 || IsTerminalStatus(Cmd->Status) || !OnCommandWait.IsBound())
+    {
+        SendJsonResponse(Connection, 200, Cmd->ToResponseJson());
+        return true;
+    }
+
+    // No thread blocks here: the router's waiter or the reactor's deadline
+    // answers, whichever comes first
+    TSharedRef<TAtomic<bool>> bAnswered = MakeShared<TAtomic<bool>>(false);
+    TWeakPtr<FHttpConnection> WeakConnection = Connection.AsShared();
+
+    Connection.ParkRequest(FPlatformTime::Seconds() + WaitSeconds,
+        [this, WeakConnection, bAnswered, CommandId]()
+        {
+            TSharedPtr<FHttpConnection> Conn = WeakConnection.Pin();
+            if (!Conn.IsValid() || bAnswered->Exchange(true)) return;
+
+            // Timed out: report the command as it stands
+            TSharedPtr<FControlCommand> Current = OnCommandQuery.Execute(CommandId);
+            if (Current.IsValid())
+            {
+                SendJsonResponse(*Conn, 200, Current->ToResponseJson());
+            }
+            else
+            {
+                SendJsonError(*Conn, 404, TEXT("Command not found"));
+            }
+            Conn->CompleteRequest();
+        });
+
+    const bool bRegistered = OnCommandWait.Execute(CommandId,
+        [this, WeakConnection, bAnswered](const FControlCommand& Settled)
+        {
+            TSharedPtr<FHttpConnection> Conn = WeakConnection.Pin();
+            if (!Conn.IsValid() || bAnswered->Exchange(true)) return;
+
+            SendJsonResponse(*Conn, 200, Settled.ToResponseJson());
+            Conn->CompleteRequest();
+        });
+
+    if (!bRegistered && !bAnswered->Exchange(true))
+    {
+        SendJsonResponse(Connection, 200, Cmd->ToResponseJson());
+        return true;
+    }
+
+    return false;
+}
+
+bool FControlHttpServer::HandleEventStream(FHttpConnection& Connection, const FHttpRequest& Request)
+{
+    // EventSource cannot set headers, so the token may also arrive as ?token=
+    FUtf8StringView TokenParam;
+    const bool bAuthorized = IsAuthorized(Request) ||
+        (Request.FindQueryParam(UTF8TEXTVIEW("token"), TokenParam) &&
+         Auth.ValidateToken(FHttpRequest::ToString(TokenParam)));
+    if (!bAuthorized)
+    {
+        SendJsonError(Connection, 401, TEXT("Unauthorized"));
+        return true;
+    }
+
+    if (!EventJournal.IsValid())
+    {
+        SendJsonError(Connection, 500, TEXT("Event stream not available"));
+        return true;
+    }
+
+    // Resume after Last-Event-ID; ?lastEventId= is accepted for the same reason as ?token=
+    uint64 AfterSeq = MAX_uint64;
+    FUtf8StringView LastEventId = Request.FindHeader(UTF8TEXTVIEW("last-event-id"));
+    if (LastEventId.IsEmpty())
+    {
+        Request.FindQueryParam(UTF8TEXTVIEW("lastEventId"), LastEventId);
+    }
+    if (!LastEventId.IsEmpty())
+    {
+        AfterSeq = FCString::Strtoui64(*FHttpRequest::ToString(LastEventId), nullptr, 10);
+    }
+
+    // A number past the head was handed out before a restart; the journal
+    // would resume live-only, so the client must refetch state as for a gap
+    const bool bStale = AfterSeq != MAX_uint64 && AfterSeq > EventJournal->GetLastSeq();
+
+    // The body has no length: it ends when the socket closes
+    Connection.SetKeepAlive(false);
+
+    TWeakPtr<FHttpConnection> WeakConnection = Connection.AsShared();
+    EventJournal->Attach(AfterSeq, [this, &Connection, &WeakConnection, bStale](
+        const TArray<TSharedRef<const FControlEvent>>& Missed, bool bGap)
+    {
+        FHttpResponseWriter Writer(200, "OK");
+        Writer.AddHeader("Cache-Control", "no-cache");
+        Writer.AddHeader("Content-Type", "text/event-stream");
+        Writer.AddHeader("X-Accel-Buffering", "no");
+        Writer.FinishStreaming();
+
+        TArray<uint8>& Out = Writer.GetBuffer();
+        FHttpResponseWriter::AppendAscii(Out, "retry: 2000\n\n");
+
+        // Events were dropped since Last-Event-ID, or it is unknown: the client should refetch state
+        if (bGap || bStale)
+        {
+            FHttpResponseWriter::AppendAscii(Out, "event: resync\ndata: {}\n\n");
+        }
+
+        for (const TSharedRef<const FControlEvent>& Event : Missed)
+        {
+            AppendSseEvent(Out, *Event);
+        }
+        Connection.Write(MoveTemp(Out));
+
+        FScopeLock Lock(&EventStreamsMutex);
+        EventStreams.Add(WeakConnection);
+    });
+
+    // Parked until the client disconnects or the server stops
+    const FHttpConnection* Raw = &Connection;
+    Connection.ParkRequest(TNumericLimits<double>::Max(), [this, Raw]()
+    {
+        FScopeLock Lock(&EventStreamsMutex);
+        EventStreams.RemoveAll([Raw](const TWeakPtr<FHttpConnection>& Weak)
+        {
+            return Weak.HasSameObject(Raw);
+        });
+    });
+
+    return false;
 }
@@ -1,16 +1,36 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "Common/TcpListener.h"
 #include "Sockets.h"
-#include "SocketSubsystem.h"
 #include "Auth/TokenAuth.h"
 #include "Models/ControlModels.h"
 
+class FControlEventJournal;
+class FHttpConnection;
+class FHttpRequest;
+class FHttpResponseWriter;
+struct FControlEvent;
+class FSocketReactor;
+class IReactorConnection;
+
+/** Which per-connection deadline closed an HTTP socket */
+enum class EHttpTimeout : uint8
+{
+    /** No request between keep-alive requests */
+    Idle,
+    /** A request started but was not complete in time (slow or stalled sender) */
+    Request,
+    /** The peer stopped reading its response */
+    Write
+};
+
 /**
  * Lightweight HTTP server for the FICSIT Control API.
- * Uses FTcpListener for accepting connections and manual HTTP parsing.
- * Supports GET and POST with JSON bodies, CORS, and Bearer auth.
+ * Sockets are owned by the shared FSocketReactor; parsed requests are
+ * routed on its worker pool. Supports GET and POST with JSON bodies, CORS,
+ * and Bearer auth. Connections are persistent (HTTP/1.1 keep-alive) and
+ * pipelined requests are answered in order on the same socket. Journaled
+ * events are also streamed as Server-Sent Events.
  */
 class FICSITCONTROL_API FControlHttpServer
 {
@@ -18,8 +38,11 @@ public:
     FControlHttpServer();
     ~FControlHttpServer();
 
-    /** Start listening on the given port. Returns true on success. */
-    bool Start(int32 Port);
+    /** Start listening on the given port via the reactor. Returns true on success. */
+    bool Start(int32 Port, TSharedRef<FSocketReactor> InReactor);
+
+    /** Also serve on a Unix domain socket at Path (call after Start). Returns true on success. */
+    bool StartLocal(const FString& Path, int32 FileMode);
 
     /** Stop the server and close all connections. */
     void Stop();
@@ -27,12 +50,91 @@ public:
     /** Get auth helper for external validation */
     FTokenAuth& GetAuth() { return Auth; }
 
-    /** Get capabilities */
-    FControlCapabilities& GetCapabilities() { return Capabilities; }
+    /** Configure keep-alive: idle timeout in seconds and max requests per connection */
+    void SetKeepAlive(float InIdleTimeout, int32 InMaxRequests)
+    {
+        KeepAliveTimeout = InIdleTimeout;
+        MaxKeepAliveRequests = InMaxRequests;
+    }
+
+    /** Idle keep-alive timeout in seconds */
+    float GetKeepAliveTimeout() const { return KeepAliveTimeout; }
+
+    /**
+     * Per-connection deadlines: a request must arrive in full within
+     * RequestTimeout of its first byte, and a pending response must make
+     * progress at least every WriteTimeout seconds.
+     */
+    void SetTimeouts(float InRequestTimeout, float InWriteTimeout)
+    {
+        RequestTimeout = InRequestTimeout;
+        WriteTimeout = InWriteTimeout;
+    }
+    float GetRequestTimeout() const { return RequestTimeout; }
+    float GetWriteTimeout() const { return WriteTimeout; }
+
+    /** Largest request line plus header block accepted */
+    void SetMaxHeaderBytes(int32 InMaxHeaderBytes) { MaxHeaderBytes = InMaxHeaderBytes; }
+    int32 GetMaxHeaderBytes() const { return MaxHeaderBytes; }
+
+    /** Largest request body accepted (Content-Length or de-chunked) */
+    void SetMaxBodyBytes(int32 InMaxBodyBytes) { MaxBodyBytes = InMaxBodyBytes; }
+    int32 GetMaxBodyBytes() const { return MaxBodyBytes; }
+
+    /**
+     * Admission limits: open connections, and requests queued or running on
+     * the workers. Bulk requests (batches, or X-Control-Priority: bulk) are
+     * refused once half of the in-flight budget is used.
+     */
+    void SetAdmissionLimits(int32 InMaxConnections, int32 InMaxInFlightRequests)
+    {
+        MaxConnections = InMaxConnections;
+        MaxInFlightRequests = InMaxInFlightRequests;
+    }
+
+    /** Called once by each connection as its socket closes (reactor thread) */
+    void OnConnectionClosed() { --NumConnections; }
+
+    /** Called by a connection dropped for missing a deadline (reactor thread) */
+    void OnConnectionTimedOut(EHttpTimeout Kind) { ++Timeouts[static_cast<int32>(Kind)]; }
+
+    /**
+     * Unsent bytes an event stream may fall behind before it is dropped; the
+     * client reconnects with Last-Event-ID and is replayed or told to resync
+     */
+    void SetMaxStreamQueuedBytes(int64 InMaxBytes) { MaxStreamQueuedBytes = InMaxBytes; }
+
+    /** Largest number of commands accepted in one batch submission */
+    void SetMaxBatchSize(int32 InMaxBatchSize) { MaxBatchSize = InMaxBatchSize; }
+
+    /** Hand a fully parsed request to the worker pool (reactor thread) */
+    void DispatchRequest(TSharedRef<FHttpConnection> Connection, TSharedRef<FHttpRequest> Request);
+
+    /** Answer a request the parser rejected and close the connection (reactor thread) */
+    void DispatchParseError(TSharedRef<FHttpConnection> Connection, int32 StatusCode);
+
+    /** Wake the reactor so queued response bytes are flushed promptly */
+    void WakeReactor();
+
+    /** Journal backing the Server-Sent Events stream */
+    void SetEventJournal(TSharedPtr<FControlEventJournal> InJournal) { EventJournal = InJournal; }
+
+    /** Push a journaled event to every open event stream (called in journal order) */
+    void BroadcastEvent(const FControlEvent& Event);
+
+    /** Replace the capabilities and re-serialize the cached document (any thread) */
+    void SetCapabilities(const FControlCapabilities& InCapabilities);
+
+    /** Current capabilities */
+    FControlCapabilities GetCapabilities() const;
+
+    /** Delegate for GET /control/v1/stats — adds sections owned elsewhere (WebSocket) */
+    DECLARE_DELEGATE_OneParam(FOnCollectStats, const TSharedRef<FJsonObject>& /* Stats */);
+    FOnCollectStats OnCollectStats;
 
     /** Delegate for command submission — set by ControlSubsystem */
-    DECLARE_DELEGATE_RetVal_TwoParams(FControlCommand, FOnCommandReceived,
-        const FString& /* Type */, TSharedPtr<FJsonObject> /* Payload */);
+    DECLARE_DELEGATE_RetVal_ThreeParams(FControlCommand, FOnCommandReceived,
+        const FString& /* Type */, TSharedPtr<FJsonObject> /* Payload */, const FString& /* Issuer */);
     FOnCommandReceived OnCommandReceived;
 
     /** Delegate for command status query */
@@ -40,37 +142,132 @@ public:
         const FString& /* CommandId */);
     FOnCommandQuery OnCommandQuery;
 
+    /** Delegate for long-poll waits — calls OnSettled once the command succeeds or fails */
+    DECLARE_DELEGATE_RetVal_TwoParams(bool, FOnCommandWait,
+        const FString& /* CommandId */, TFunction<void(const FControlCommand&)> /* OnSettled */);
+    FOnCommandWait OnCommandWait;
+
+    /** Delegate for batch submission — returns one command per request, in order */
+    DECLARE_DELEGATE_RetVal_OneParam(TArray<FControlCommand>, FOnBatchReceived,
+        const TArray<FControlCommandRequest>& /* Requests */);
+    FOnBatchReceived OnBatchReceived;
+
 private:
-    /** Called by FTcpListener when a new connection arrives */
-    bool HandleConnection(FSocket* ClientSocket, const FIPv4Endpoint& Endpoint);
+    /** Called by the reactor when a new connection arrives */
+    TSharedPtr<IReactorConnection> HandleConnection(FSocket* ClientSocket);
 
-    /** Process a single HTTP request on a client socket */
-    void ProcessRequest(FSocket* ClientSocket);
+    /**
+     * Route and answer one HTTP request (worker thread).
+     * Returns false if a handler parked the request to complete it later.
+     */
+    bool ProcessRequest(FHttpConnection& Connection, const FHttpRequest& Request);
 
-    /** Parse an HTTP request into method, path, headers, body */
-    bool ParseHttpRequest(const FString& RawRequest,
-        FString& OutMethod, FString& OutPath,
-        TMap<FString, FString>& OutHeaders, FString& OutBody);
+    /** Send an HTTP response. ExtraHeaders are complete "Name: value\r\n" lines. */
+    void SendResponse(FHttpConnection& Connection, int32 StatusCode, FAnsiStringView StatusText,
+        FAnsiStringView ContentType, const FString& Body, FAnsiStringView ExtraHeaders = FAnsiStringView());
+    void SendResponse(FHttpConnection& Connection, int32 StatusCode, FAnsiStringView StatusText,
+        FAnsiStringView ContentType, TArrayView<const uint8> Body, FAnsiStringView ExtraHeaders = FAnsiStringView());
 
-    /** Send an HTTP response */
-    void SendResponse(FSocket* Socket, int32 StatusCode, const FString& StatusText,
-        const FString& ContentType, const FString& Body);
+    /** Append the Connection, Content-Type and extra headers shared by every response */
+    void WriteResponseHeaders(FHttpResponseWriter& Writer, FHttpConnection& Connection,
+        FAnsiStringView ContentType, FAnsiStringView ExtraHeaders) const;
 
     /** Send a JSON response with CORS headers */
-    void SendJsonResponse(FSocket* Socket, int32 StatusCode, const TSharedRef<FJsonObject>& Json);
+    void SendJsonResponse(FHttpConnection& Connection, int32 StatusCode, const TSharedRef<FJsonObject>& Json);
 
     /** Send a JSON error */
-    void SendJsonError(FSocket* Socket, int32 StatusCode, const FString& ErrorMessage);
+    void SendJsonError(FHttpConnection& Connection, int32 StatusCode, const FString& ErrorMessage);
+
+    /** Send 503 with Retry-After */
+    void SendServiceUnavailable(FHttpConnection& Connection, const FString& ErrorMessage);
+
+    /** Decide whether the connection stays open after this request */
+    void ApplyKeepAlive(FHttpConnection& Connection, const FHttpRequest& Request);
+
+    /** If-None-Match evaluation against a strong ETag */
+    static bool MatchesETag(FUtf8StringView IfNoneMatch, FUtf8StringView ETag);
+
+    /** Bulk automation traffic yields to interactive requests */
+    static bool IsBulkRequest(const FHttpRequest& Request);
 
     /** Route handlers */
-    void HandleCapabilities(FSocket* Socket);
-    void HandlePostCommand(FSocket* Socket, const TMap<FString, FString>& Headers,
-        const FString& Body);
-    void HandleGetCommand(FSocket* Socket, const TMap<FString, FString>& Headers,
+    void HandleCapabilities(FHttpConnection& Connection, const FHttpRequest& Request);
+    void HandlePostCommand(FHttpConnection& Connection, const FHttpRequest& Request);
+    void HandlePostBatch(FHttpConnection& Connection, const FHttpRequest& Request);
+    bool HandleGetCommand(FHttpConnection& Connection, const FHttpRequest& Request,
         const FString& CommandId);
+    bool HandleEventStream(FHttpConnection& Connection, const FHttpRequest& Request);
+    void HandleStats(FHttpConnection& Connection, const FHttpRequest& Request);
 
-    TUniquePtr<FTcpListener> Listener;
+    /** Append one event in text/event-stream framing */
+    static void AppendSseEvent(TArray<uint8>& Out, const FControlEvent& Event);
+
+    /** Validate the request's Authorization header */
+    bool IsAuthorized(const FHttpRequest& Request) const;
+
+    /** Fingerprint of the bearer token a request was made with, empty if none */
+    static FString GetIssuer(const FHttpRequest& Request);
+
+    TSharedPtr<FSocketReactor> Reactor;
+    int32 ListenerId = INDEX_NONE;
+    int32 LocalListenerId = INDEX_NONE;
     FTokenAuth Auth;
+    /** A response body serialized once and served until replaced */
+    struct FCachedDocument
+    {
+        TArray<uint8> Body;
+        /** ETag and Cache-Control header lines */
+        TArray<uint8> Headers;
+        /** The quoted tag, owned here so it cannot move when Headers grows */
+        TArray<uint8> ETag;
+
+        FUtf8StringView GetETag() const
+        {
+            return FUtf8StringView(reinterpret_cast<const UTF8CHAR*>(ETag.GetData()), ETag.Num());
+        }
+    };
+
     FControlCapabilities Capabilities;
-    bool bRunning = false;
+    TSharedPtr<const FCachedDocument> CapabilitiesDocument;
+    mutable FCriticalSection CapabilitiesMutex;
+    TAtomic<bool> bRunning { false };
+
+    /** Seconds an idle keep-alive connection waits for its next request */
+    float KeepAliveTimeout = 5.0f;
+
+    /** Requests served on one connection before it is closed */
+    int32 MaxKeepAliveRequests = 100;
+
+    /** Seconds to receive a whole request, and to make progress on a response */
+    float RequestTimeout = 10.0f;
+    float WriteTimeout = 30.0f;
+
+    /** Largest accepted request line plus headers in bytes */
+    int32 MaxHeaderBytes = 16 * 1024;
+
+    /** Largest accepted request body in bytes */
+    int32 MaxBodyBytes = 8 * 1024 * 1024;
+
+    /** Largest accepted batch submission */
+    int32 MaxBatchSize = 250;
+
+    /** Admission limits and the counters they bound */
+    int32 MaxConnections = 128;
+    int32 MaxInFlightRequests = 64;
+    TAtomic<int32> NumConnections { 0 };
+    TAtomic<int32> InFlightRequests { 0 };
+
+    /** Counters reported by /control/v1/stats */
+    TAtomic<int64> RefusedConnections { 0 };
+    TAtomic<int64> ShedRequests { 0 };
+    TAtomic<int64> Timeouts[3] = { 0, 0, 0 };
+
+    TSharedPtr<FControlEventJournal> EventJournal;
+
+    int64 MaxStreamQueuedBytes = 1024 * 1024;
+    TAtomic<int64> SlowStreamEvictions { 0 };
+
+    /** Connections holding GET /control/v1/events open */
+    TArray<TWeakPtr<FHttpConnection>> EventStreams;
+    FCriticalSection EventStreamsMutex;
 };
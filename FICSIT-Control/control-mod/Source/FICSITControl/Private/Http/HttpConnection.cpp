@@ -0,0 +1,324 @@
+#include "HttpConnection.h"
+#include "ControlHttpServer.h"
+#include "Misc/ScopeLock.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogHttpConnection, Log, All);
+
+// Bytes buffered beyond the current request (pipelining / chunk framing slack)
+static constexpr int32 ReceiveSlack = 64 * 1024;
+
+// Sent bytes kept at the front of a backlogged send buffer before it is compacted
+static constexpr int32 SendCompactBytes = 64 * 1024;
+
+FHttpConnection::FHttpConnection(FSocket* InSocket, FControlHttpServer& InServer)
+    : Socket(InSocket)
+    , Server(InServer)
+    , Parser(InServer.GetMaxHeaderBytes(), InServer.GetMaxBodyBytes())
+    , MaxHeaderBytes(InServer.GetMaxHeaderBytes())
+    , LastActivity(FPlatformTime::Seconds())
+{
+    Deadline = LastActivity + GetIdleTimeout();
+}
+
+FHttpConnection::~FHttpConnection()
+{
+    OnClosed();
+}
+
+EServiceResult FHttpConnection::Service(double Now)
+{
+    FScopeLock Lock(&Mutex);
+    if (bClosed || bOverflowed) return EServiceResult::Close;
+
+    bool bProgress = false;
+
+    // Flush whatever the workers have written so far
+    bool bSent = false;
+    if (FlushSendBuffer(bSent) == ESocketIoResult::Closed)
+    {
+        return EServiceResult::Close;
+    }
+    if (bSent)
+    {
+        SendProgressAt = Now;
+        bProgress = true;
+    }
+    if (bCloseAfterFlush && SendOffset >= SendBuffer.Num())
+    {
+        return EServiceResult::Close;
+    }
+
+    // Pull in new bytes while there is room for another request
+    const int32 MaxBuffered = GetMaxBuffered();
+    if (!bCloseAfterFlush && ReceiveBuffer.Num() < MaxBuffered)
+    {
+        const int32 Before = ReceiveBuffer.Num();
+        if (FSocketReactor::RecvAvailable(Socket, ReceiveBuffer, MaxBuffered - Before) == ESocketIoResult::Closed)
+        {
+            return EServiceResult::Close;
+        }
+        if (ReceiveBuffer.Num() > Before)
+        {
+            bProgress = true;
+        }
+    }
+
+    // The request clock starts with the first byte of the next request
+    if (!bRequestInFlight && ReceiveBuffer.Num() > 0 && RequestStartedAt <= 0.0)
+    {
+        RequestStartedAt = Now;
+    }
+
+    // Dispatch the next pipelined request once the previous one is answered
+    if (!bRequestInFlight && !bCloseAfterFlush && ReceiveBuffer.Num() > 0)
+    {
+        switch (Parser.Parse(ReceiveBuffer))
+        {
+        case EHttpParseResult::NeedMore:
+            break;
+
+        case EHttpParseResult::Complete:
+            bRequestInFlight = true;
+            bProgress = true;
+            RequestStartedAt = 0.0;
+            Server.DispatchRequest(AsShared(), Parser.TakeRequest(ReceiveBuffer));
+            break;
+
+        case EHttpParseResult::Error:
+            // Answer with the parser's status, then close: framing is lost
+            UE_LOG(LogHttpConnection, Verbose, TEXT("Rejecting request with status %d"), Parser.GetErrorStatus());
+            bRequestInFlight = true;
+            bProgress = true;
+            RequestStartedAt = 0.0;
+            ReceiveBuffer.Reset();
+            Server.DispatchParseError(AsShared(), Parser.GetErrorStatus());
+            break;
+        }
+    }
+
+    if (bProgress)
+    {
+        LastActivity = Now;
+    }
+
+    // Timeouts are enforced by the reactor's timer wheel
+    UpdateDeadline();
+    return bProgress ? EServiceResult::Busy : EServiceResult::Idle;
+}
+
+EServiceResult FHttpConnection::OnDeadline(double Now)
+{
+    // A parked request that ran out of time is answered, not dropped
+    if (TUniqueFunction<void()> Expired = TakeExpiredPark(Now))
+    {
+        Expired();
+        FScopeLock Lock(&Mutex);
+        UpdateDeadline();
+        return EServiceResult::Busy;
+    }
+
+    FScopeLock Lock(&Mutex);
+    if (SendOffset < SendBuffer.Num())
+    {
+        Server.OnConnectionTimedOut(EHttpTimeout::Write);
+    }
+    else if (RequestStartedAt > 0.0)
+    {
+        UE_LOG(LogHttpConnection, Verbose, TEXT("Request not received within %.1fs"), Server.GetRequestTimeout());
+        Server.OnConnectionTimedOut(EHttpTimeout::Request);
+    }
+    else
+    {
+        UE_LOG(LogHttpConnection, Verbose, TEXT("%s within %.1fs"),
+            RequestCount == 0 ? TEXT("No request") : TEXT("No further request"), GetIdleTimeout());
+        Server.OnConnectionTimedOut(EHttpTimeout::Idle);
+    }
+    return EServiceResult::Close;
+}
+
+void FHttpConnection::UpdateDeadline()
+{
+    double Next = 0.0;
+    auto Consider = [&Next](double Candidate)
+    {
+        if (Candidate > 0.0 && (Next <= 0.0 || Candidate < Next))
+        {
+            Next = Candidate;
+        }
+    };
+
+    const bool bSendPending = SendOffset < SendBuffer.Num();
+    if (bSendPending)
+    {
+        Consider(SendProgressAt + Server.GetWriteTimeout());
+    }
+
+    if (bRequestInFlight)
+    {
+        if (ParkExpire && ParkDeadline < TNumericLimits<double>::Max())
+        {
+            Consider(ParkDeadline);
+        }
+    }
+    else if (RequestStartedAt > 0.0)
+    {
+        Consider(RequestStartedAt + Server.GetRequestTimeout());
+    }
+    else if (!bSendPending)
+    {
+        Consider(LastActivity + GetIdleTimeout());
+    }
+
+    Deadline = Next;
+}
+
+double FHttpConnection::GetIdleTimeout() const
+{
+    return RequestCount == 0 ? Server.GetRequestTimeout() : Server.GetKeepAliveTimeout();
+}
+
+void FHttpConnection::OnClosed()
+{
+    {
+        FScopeLock Lock(&Mutex);
+        bClosed = true;
+        if (Socket)
+        {
+            FSocketReactor::DestroySocket(Socket);
+            Socket = nullptr;
+            Server.OnConnectionClosed();
+        }
+    }
+
+    // Release whatever the parked request was waiting on
+    if (TUniqueFunction<void()> Expired = TakeExpiredPark(-1.0))
+    {
+        Expired();
+    }
+}
+
+void FHttpConnection::Write(const uint8* Data, int32 Len)
+{
+    FScopeLock Lock(&Mutex);
+    if (bClosed || Len <= 0) return;
+    if (SendBuffer.Num() == 0)
+    {
+        SendProgressAt = FPlatformTime::Seconds();
+    }
+    SendBuffer.Append(Data, Len);
+}
+
+void FHttpConnection::Write(TArray<uint8>&& Data)
+{
+    FScopeLock Lock(&Mutex);
+    if (bClosed || Data.Num() == 0) return;
+
+    if (SendBuffer.Num() == 0)
+    {
+        SendOffset = 0;
+        SendProgressAt = FPlatformTime::Seconds();
+        Swap(SendBuffer, Data);
+        Data.Reset();
+    }
+    else
+    {
+        SendBuffer.Append(Data);
+    }
+}
+
+bool FHttpConnection::WantsRead() const
+{
+    // Service stops reading once the buffer is full or the response is the last
+    FScopeLock Lock(&Mutex);
+    return !bCloseAfterFlush && ReceiveBuffer.Num() < GetMaxBuffered();
+}
+
+bool FHttpConnection::WantsWrite() const
+{
+    FScopeLock Lock(&Mutex);
+    return SendOffset < SendBuffer.Num();
+}
+
+int32 FHttpConnection::GetMaxBuffered() const
+{
+    return MaxHeaderBytes + Parser.GetMaxBodyBytes() + ReceiveSlack;
+}
+
+bool FHttpConnection::WriteEvent(const uint8* Data, int32 Len, int64 MaxPending)
+{
+    FScopeLock Lock(&Mutex);
+    if (bClosed || bOverflowed) return false;
+
+    if (static_cast<int64>(SendBuffer.Num() - SendOffset) + Len > MaxPending)
+    {
+        bOverflowed = true;
+        return false;
+    }
+
+    if (SendBuffer.Num() == 0)
+    {
+        SendProgressAt = FPlatformTime::Seconds();
+    }
+    SendBuffer.Append(Data, Len);
+    return true;
+}
+
+void FHttpConnection::CompleteRequest()
+{
+    {
+        FScopeLock Lock(&Mutex);
+        bRequestInFlight = false;
+        ParkExpire = nullptr;
+        if (!bKeepAlive)
+        {
+            bCloseAfterFlush = true;
+        }
+    }
+    Server.WakeReactor();
+}
+
+void FHttpConnection::ParkRequest(double Deadline, TUniqueFunction<void()> OnExpire)
+{
+    FScopeLock Lock(&Mutex);
+    ParkDeadline = Deadline;
+    ParkExpire = MoveTemp(OnExpire);
+}
+
+TUniqueFunction<void()> FHttpConnection::TakeExpiredPark(double Now)
+{
+    FScopeLock Lock(&Mutex);
+    if (!ParkExpire || (Now >= 0.0 && Now < ParkDeadline))
+    {
+        return nullptr;
+    }
+    TUniqueFunction<void()> Expired = MoveTemp(ParkExpire);
+    ParkExpire = nullptr;
+    return Expired;
+}
+
+ESocketIoResult FHttpConnection::FlushSendBuffer(bool& bOutProgress)
+{
+    while (SendOffset < SendBuffer.Num())
+    {
+        int32 BytesSent = 0;
+        const ESocketIoResult Result = FSocketReactor::SendSome(Socket,
+            SendBuffer.GetData() + SendOffset, SendBuffer.Num() - SendOffset, BytesSent);
+        if (Result != ESocketIoResult::Ok)
+        {
+            // A stream that never drains fully would otherwise keep every byte
+            // it ever sent; drop the sent prefix once it outweighs the rest
+            if (SendOffset >= SendCompactBytes && SendOffset >= SendBuffer.Num() - SendOffset)
+            {
+                SendBuffer.RemoveAt(0, SendOffset, false);
+                SendOffset = 0;
+            }
+            return Result;
+        }
+        SendOffset += BytesSent;
+        bOutProgress = true;
+    }
+
+    SendBuffer.Reset();
+    SendOffset = 0;
+    return ESocketIoResult::Ok;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Sockets.h"
+#include "Net/SocketReactor.h"
+#include "HttpRequestParser.h"
+
+class FControlHttpServer;
+
+/**
+ * One client socket accepted by the HTTP server.
+ * Owned by the socket reactor: received bytes are fed to an incremental
+ * parser without blocking, pipelined requests are split off one at a time
+ * and handed to the worker pool, and responses written by workers are
+ * flushed back by the reactor.
+ */
+class FHttpConnection : public IReactorConnection, public TSharedFromThis<FHttpConnection>
+{
+public:
+    FHttpConnection(FSocket* InSocket, FControlHttpServer& InServer);
+    virtual ~FHttpConnection();
+
+    // IReactorConnection
+    virtual EServiceResult Service(double Now) override;
+    virtual void OnClosed() override;
+    virtual double GetDeadline() const override { return Deadline; }
+    virtual EServiceResult OnDeadline(double Now) override;
+    virtual FSocket* GetSocket() const override { return Socket; }
+    virtual bool WantsRead() const override;
+    virtual bool WantsWrite() const override;
+
+    /** Queue response bytes (any thread). Flushed by the reactor. */
+    void Write(const uint8* Data, int32 Len);
+
+    /**
+     * Queue a whole buffer (any thread). When nothing is pending the buffer is
+     * swapped in instead of copied; Data receives the old, empty send buffer.
+     */
+    void Write(TArray<uint8>&& Data);
+
+    /**
+     * Queue a streamed event (any thread). Returns false, and drops the
+     * connection on the reactor's next pass, when the bytes still unsent
+     * would exceed MaxPending: a reader that slow is cut off rather than
+     * buffered for without bound.
+     */
+    bool WriteEvent(const uint8* Data, int32 Len, int64 MaxPending);
+
+    /** Mark the in-flight request as answered (any thread) */
+    void CompleteRequest();
+
+    /**
+     * Leave the in-flight request open after its handler returns. Whoever
+     * answers it later calls CompleteRequest; if nobody has by Deadline, or
+     * the socket closes first, the reactor runs OnExpire instead.
+     */
+    void ParkRequest(double Deadline, TUniqueFunction<void()> OnExpire);
+
+    /** Whether the response to the current request keeps the socket open */
+    bool ShouldKeepAlive() const { return bKeepAlive; }
+    void SetKeepAlive(bool bInKeepAlive) { bKeepAlive = bInKeepAlive; }
+
+    /** Number of requests received on this connection so far */
+    int32 GetRequestCount() const { return RequestCount; }
+    void IncrementRequestCount() { ++RequestCount; }
+
+private:
+    /** Most received bytes held at once: a whole request plus room for the next */
+    int32 GetMaxBuffered() const;
+
+    /** Push queued response bytes to the socket. Caller holds Mutex. */
+    ESocketIoResult FlushSendBuffer(bool& bOutProgress);
+
+    /**
+     * Recompute Deadline from the connection's state. Caller holds Mutex.
+     * Idle: see GetIdleTimeout. Partway through a request:
+     * the request timeout, counted from its first byte, so trickled headers
+     * cannot hold the socket. Response pending: the write timeout, counted
+     * from the last byte the peer accepted. Parked: the park deadline.
+     */
+    void UpdateDeadline();
+
+    /**
+     * How long the connection may sit with no request started: the request
+     * timeout before its first request, the keep-alive timeout after one.
+     */
+    double GetIdleTimeout() const;
+
+    /** Detach the parked request's expiry handler if it is due (or Now < 0 for any) */
+    TUniqueFunction<void()> TakeExpiredPark(double Now);
+
+    FSocket* Socket;
+    FControlHttpServer& Server;
+
+    /** Reactor-thread only */
+    TArray<uint8> ReceiveBuffer;
+    FHttpRequestParser Parser;
+    int32 MaxHeaderBytes;
+    double LastActivity;
+    /** When the first byte of the request being received arrived, or 0 */
+    double RequestStartedAt = 0.0;
+    double Deadline = 0.0;
+
+    /** Guarded by Mutex: shared between reactor and workers */
+    TArray<uint8> SendBuffer;
+    int32 SendOffset = 0;
+    /** When the peer last accepted bytes, or the send buffer last became non-empty */
+    double SendProgressAt = 0.0;
+    bool bRequestInFlight = false;
+    bool bCloseAfterFlush = false;
+    bool bClosed = false;
+    /** A streamed event did not fit under the pending-byte limit */
+    bool bOverflowed = false;
+    double ParkDeadline = 0.0;
+    TUniqueFunction<void()> ParkExpire;
+    mutable FCriticalSection Mutex;
+
+    /** Worker-side state for the in-flight request */
+    bool bKeepAlive = false;
+    int32 RequestCount = 0;
+};
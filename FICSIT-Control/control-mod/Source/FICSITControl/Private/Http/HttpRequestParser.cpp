@@ -0,0 +1,411 @@
+#include "HttpRequestParser.h"
+
+// Longest chunk-size line (hex digits plus extensions) we are willing to buffer
+static constexpr int32 MaxChunkLineBytes = 1024;
+
+static FORCEINLINE uint8 ToLowerAscii(uint8 C)
+{
+    return (C >= 'A' && C <= 'Z') ? C + ('a' - 'A') : C;
+}
+
+static FORCEINLINE bool IsOws(uint8 C)
+{
+    return C == ' ' || C == '\t';
+}
+
+// -- FHttpRequest --
+
+FUtf8StringView FHttpRequest::FindHeader(FUtf8StringView Name) const
+{
+    for (const TPair<FHttpSpan, FHttpSpan>& Header : Headers)
+    {
+        if (EqualsIgnoreCase(View(Header.Key), Name))
+        {
+            return View(Header.Value);
+        }
+    }
+    return FUtf8StringView();
+}
+
+bool FHttpRequest::FindQueryParam(FUtf8StringView Name, FUtf8StringView& OutValue) const
+{
+    FUtf8StringView Remaining = GetQuery();
+    while (Remaining.Len() > 0)
+    {
+        int32 Amp = 0;
+        while (Amp < Remaining.Len() && Remaining[Amp] != '&') ++Amp;
+
+        const FUtf8StringView Param = Remaining.Left(Amp);
+        int32 Eq = 0;
+        while (Eq < Param.Len() && Param[Eq] != '=') ++Eq;
+
+        if (Equals(Param.Left(Eq), Name))
+        {
+            OutValue = Eq < Param.Len() ? Param.RightChop(Eq + 1) : FUtf8StringView();
+            return true;
+        }
+
+        Remaining = Remaining.RightChop(Amp + 1);
+    }
+    return false;
+}
+
+FString FHttpRequest::GetBodyAsString() const
+{
+    return ToString(View(Body));
+}
+
+bool FHttpRequest::Equals(FUtf8StringView A, FUtf8StringView B)
+{
+    return A.Len() == B.Len() && FMemory::Memcmp(A.GetData(), B.GetData(), A.Len()) == 0;
+}
+
+bool FHttpRequest::EqualsIgnoreCase(FUtf8StringView A, FUtf8StringView B)
+{
+    if (A.Len() != B.Len()) return false;
+
+    const uint8* PA = reinterpret_cast<const uint8*>(A.GetData());
+    const uint8* PB = reinterpret_cast<const uint8*>(B.GetData());
+    for (int32 i = 0; i < A.Len(); ++i)
+    {
+        if (ToLowerAscii(PA[i]) != ToLowerAscii(PB[i])) return false;
+    }
+    return true;
+}
+
+bool FHttpRequest::ContainsIgnoreCase(FUtf8StringView Haystack, FUtf8StringView Needle)
+{
+    for (int32 i = 0; i + Needle.Len() <= Haystack.Len(); ++i)
+    {
+        if (EqualsIgnoreCase(Haystack.Mid(i, Needle.Len()), Needle)) return true;
+    }
+    return false;
+}
+
+FString FHttpRequest::ToString(FUtf8StringView Text)
+{
+    if (Text.Len() == 0) return FString();
+
+    FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Text.GetData()), Text.Len());
+    return FString(Converted.Length(), Converted.Get());
+}
+
+// -- FHttpRequestParser --
+
+FHttpRequestParser::FHttpRequestParser(int32 InMaxHeaderBytes, int32 InMaxBodyBytes)
+    : MaxHeaderBytes(InMaxHeaderBytes)
+    , MaxBodyBytes(InMaxBodyBytes)
+    , Pending(MakeShared<FHttpRequest>())
+{
+}
+
+void FHttpRequestParser::Reset()
+{
+    State = EState::Headers;
+    ScanPos = 0;
+    BodyStart = 0;
+    ReadPos = 0;
+    WritePos = 0;
+    ChunkRemaining = 0;
+    ContentLength = 0;
+    ErrorStatus = 0;
+    Pending = MakeShared<FHttpRequest>();
+}
+
+EHttpParseResult FHttpRequestParser::Fail(int32 Status)
+{
+    State = EState::Error;
+    ErrorStatus = Status;
+    return EHttpParseResult::Error;
+}
+
+int32 FHttpRequestParser::FindCrlf(const uint8* Data, int32 From, int32 Num)
+{
+    for (int32 i = From; i + 1 < Num; ++i)
+    {
+        if (Data[i] == '\r' && Data[i + 1] == '\n') return i;
+    }
+    return INDEX_NONE;
+}
+
+EHttpParseResult FHttpRequestParser::Parse(TArray<uint8>& Buffer)
+{
+    uint8* Data = Buffer.GetData();
+    const int32 Num = Buffer.Num();
+
+    for (;;)
+    {
+        switch (State)
+        {
+        case EState::Headers:
+        {
+            // Resume the terminator search a few bytes back in case it straddles reads
+            int32 HeaderEnd = INDEX_NONE;
+            for (int32 i = FMath::Max(0, ScanPos - 3); i + 3 < Num; ++i)
+            {
+                if (Data[i] == '\r' && Data[i + 1] == '\n' && Data[i + 2] == '\r' && Data[i + 3] == '\n')
+                {
+                    HeaderEnd = i + 4;
+                    break;
+                }
+            }
+
+            if (HeaderEnd == INDEX_NONE)
+            {
+                ScanPos = Num;
+                return Num > MaxHeaderBytes ? Fail(431) : EHttpParseResult::NeedMore;
+            }
+            if (HeaderEnd > MaxHeaderBytes)
+            {
+                return Fail(431);
+            }
+            if (!ParseHeaderBlock(Data, HeaderEnd))
+            {
+                return EHttpParseResult::Error;
+            }
+
+            BodyStart = HeaderEnd;
+            ReadPos = HeaderEnd;
+            WritePos = HeaderEnd;
+            break;
+        }
+
+        case EState::FixedBody:
+            if (Num - BodyStart < ContentLength)
+            {
+                return EHttpParseResult::NeedMore;
+            }
+            Pending->Body = { BodyStart, static_cast<int32>(ContentLength) };
+            ReadPos = BodyStart + static_cast<int32>(ContentLength);
+            State = EState::Complete;
+            break;
+
+        case EState::ChunkSize:
+        {
+            const int32 LineEnd = FindCrlf(Data, ReadPos, Num);
+            if (LineEnd == INDEX_NONE)
+            {
+                return Num - ReadPos > MaxChunkLineBytes ? Fail(400) : EHttpParseResult::NeedMore;
+            }
+
+            int64 Size = 0;
+            int32 Digits = 0;
+            for (int32 i = ReadPos; i < LineEnd && Data[i] != ';' && !IsOws(Data[i]); ++i, ++Digits)
+            {
+                const uint8 C = ToLowerAscii(Data[i]);
+                int32 Nibble;
+                if (C >= '0' && C <= '9') Nibble = C - '0';
+                else if (C >= 'a' && C <= 'f') Nibble = C - 'a' + 10;
+                else return Fail(400);
+
+                Size = (Size << 4) | Nibble;
+                if (Size > MaxBodyBytes) return Fail(413);
+            }
+            if (Digits == 0)
+            {
+                return Fail(400);
+            }
+            if ((WritePos - BodyStart) + Size > MaxBodyBytes)
+            {
+                return Fail(413);
+            }
+
+            ReadPos = LineEnd + 2;
+            ChunkRemaining = Size;
+            State = Size == 0 ? EState::Trailers : EState::ChunkData;
+            break;
+        }
+
+        case EState::ChunkData:
+        {
+            // De-frame in place: slide chunk bytes down over the size lines
+            const int32 Available = static_cast<int32>(FMath::Min<int64>(ChunkRemaining, Num - ReadPos));
+            if (Available > 0)
+            {
+                if (WritePos != ReadPos)
+                {
+                    FMemory::Memmove(Data + WritePos, Data + ReadPos, Available);
+                }
+                WritePos += Available;
+                ReadPos += Available;
+                ChunkRemaining -= Available;
+            }
+
+            if (ChunkRemaining > 0)
+            {
+                return EHttpParseResult::NeedMore;
+            }
+            State = EState::ChunkDataEnd;
+            break;
+        }
+
+        case EState::ChunkDataEnd:
+            if (Num - ReadPos < 2)
+            {
+                return EHttpParseResult::NeedMore;
+            }
+            if (Data[ReadPos] != '\r' || Data[ReadPos + 1] != '\n')
+            {
+                return Fail(400);
+            }
+            ReadPos += 2;
+            State = EState::ChunkSize;
+            break;
+
+        case EState::Trailers:
+        {
+            // Trailer fields are accepted and ignored; an empty line ends the body
+            const int32 LineEnd = FindCrlf(Data, ReadPos, Num);
+            if (LineEnd == INDEX_NONE)
+            {
+                return Num - ReadPos > MaxHeaderBytes ? Fail(431) : EHttpParseResult::NeedMore;
+            }
+
+            const bool bEmptyLine = LineEnd == ReadPos;
+            ReadPos = LineEnd + 2;
+            if (bEmptyLine)
+            {
+                Pending->Body = { BodyStart, WritePos - BodyStart };
+                State = EState::Complete;
+            }
+            break;
+        }
+
+        case EState::Complete:
+            return EHttpParseResult::Complete;
+
+        case EState::Error:
+            return EHttpParseResult::Error;
+        }
+    }
+}
+
+bool FHttpRequestParser::ParseHeaderBlock(const uint8* Data, int32 HeaderEnd)
+{
+    FHttpRequest& Request = *Pending;
+    Request.Headers.Reset();
+
+    // Request line: METHOD SP request-target SP HTTP-version
+    const int32 LineEnd = FindCrlf(Data, 0, HeaderEnd);
+    int32 Pos = 0;
+
+    auto NextToken = [Data, LineEnd, &Pos]() -> FHttpSpan
+    {
+        while (Pos < LineEnd && Data[Pos] == ' ') ++Pos;
+        const int32 Start = Pos;
+        while (Pos < LineEnd && Data[Pos] != ' ') ++Pos;
+        return { Start, Pos - Start };
+    };
+
+    Request.Method = NextToken();
+    const FHttpSpan Target = NextToken();
+    Request.Version = NextToken();
+
+    if (Request.Method.Len == 0 || Target.Len == 0 || Request.Version.Len == 0 ||
+        !FHttpRequest::Equals(Request.View(Request.Version).Left(7), UTF8TEXTVIEW("HTTP/1.")))
+    {
+        Fail(400);
+        return false;
+    }
+
+    // Split the target into path and query
+    Request.Path = Target;
+    Request.Query = { Target.Offset + Target.Len, 0 };
+    for (int32 i = Target.Offset; i < Target.Offset + Target.Len; ++i)
+    {
+        if (Data[i] == '?')
+        {
+            Request.Path = { Target.Offset, i - Target.Offset };
+            Request.Query = { i + 1, Target.Offset + Target.Len - i - 1 };
+            break;
+        }
+    }
+
+    // Header fields: name ":" OWS value OWS
+    for (int32 Start = LineEnd + 2; Start < HeaderEnd - 2; )
+    {
+        const int32 End = FindCrlf(Data, Start, HeaderEnd);
+        if (IsOws(Data[Start]))
+        {
+            Fail(400); // Obsolete line folding
+            return false;
+        }
+
+        int32 Colon = Start;
+        while (Colon < End && Data[Colon] != ':') ++Colon;
+        if (Colon == End || Colon == Start)
+        {
+            Fail(400);
+            return false;
+        }
+
+        int32 ValueStart = Colon + 1;
+        int32 ValueEnd = End;
+        while (ValueStart < ValueEnd && IsOws(Data[ValueStart])) ++ValueStart;
+        while (ValueEnd > ValueStart && IsOws(Data[ValueEnd - 1])) --ValueEnd;
+
+        Request.Headers.Emplace(FHttpSpan{ Start, Colon - Start }, FHttpSpan{ ValueStart, ValueEnd - ValueStart });
+        Start = End + 2;
+    }
+
+    // Body framing
+    const FUtf8StringView TransferEncoding = Request.FindHeader(UTF8TEXTVIEW("transfer-encoding"));
+    const FUtf8StringView ContentLengthValue = Request.FindHeader(UTF8TEXTVIEW("content-length"));
+
+    if (TransferEncoding.Len() > 0)
+    {
+        if (ContentLengthValue.Len() > 0)
+        {
+            Fail(400); // Ambiguous framing
+            return false;
+        }
+        if (!FHttpRequest::EqualsIgnoreCase(TransferEncoding, UTF8TEXTVIEW("chunked")))
+        {
+            Fail(501);
+            return false;
+        }
+        State = EState::ChunkSize;
+        return true;
+    }
+
+    ContentLength = 0;
+    for (int32 i = 0; i < ContentLengthValue.Len(); ++i)
+    {
+        const uint8 C = static_cast<uint8>(ContentLengthValue[i]);
+        if (C < '0' || C > '9')
+        {
+            Fail(400);
+            return false;
+        }
+        ContentLength = ContentLength * 10 + (C - '0');
+        if (ContentLength > MaxBodyBytes)
+        {
+            Fail(413); // Rejected before the body is read
+            return false;
+        }
+    }
+
+    State = EState::FixedBody;
+    return true;
+}
+
+TSharedRef<FHttpRequest> FHttpRequestParser::TakeRequest(TArray<uint8>& Buffer)
+{
+    check(State == EState::Complete);
+
+    TSharedRef<FHttpRequest> Request = Pending;
+    const int32 Consumed = ReadPos;
+
+    // Hand the buffer itself to the request; only pipelined bytes are copied
+    TArray<uint8> Remainder;
+    if (Buffer.Num() > Consumed)
+    {
+        Remainder.Append(Buffer.GetData() + Consumed, Buffer.Num() - Consumed);
+    }
+    Request->Data = MoveTemp(Buffer);
+    Request->Data.SetNum(Consumed, false);
+    Buffer = MoveTemp(Remainder);
+
+    Reset();
+    return Request;
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/StringView.h"
+
+/** A byte range inside a request buffer */
+struct FHttpSpan
+{
+    int32 Offset = 0;
+    int32 Len = 0;
+};
+
+/**
+ * A fully received HTTP request.
+ * Owns the raw UTF-8 bytes; every accessor returns a non-owning view into
+ * them, so parsing allocates no per-field strings.
+ */
+class FHttpRequest
+{
+public:
+    FUtf8StringView GetMethod() const { return View(Method); }
+    FUtf8StringView GetPath() const { return View(Path); }
+    FUtf8StringView GetQuery() const { return View(Query); }
+    FUtf8StringView GetVersion() const { return View(Version); }
+    TArrayView<const uint8> GetBody() const { return TArrayView<const uint8>(Data.GetData() + Body.Offset, Body.Len); }
+
+    /** Case-insensitive header lookup. Returns an empty view if absent. */
+    FUtf8StringView FindHeader(FUtf8StringView Name) const;
+
+    /** Look up a query string parameter (not percent-decoded). Returns false if absent. */
+    bool FindQueryParam(FUtf8StringView Name, FUtf8StringView& OutValue) const;
+
+    /** Convert the body to an FString (for the JSON reader) */
+    FString GetBodyAsString() const;
+
+    /** Byte-exact comparison */
+    static bool Equals(FUtf8StringView A, FUtf8StringView B);
+
+    /** ASCII case-insensitive comparison */
+    static bool EqualsIgnoreCase(FUtf8StringView A, FUtf8StringView B);
+
+    /** ASCII case-insensitive substring search */
+    static bool ContainsIgnoreCase(FUtf8StringView Haystack, FUtf8StringView Needle);
+
+    /** Convert a view to an FString */
+    static FString ToString(FUtf8StringView Text);
+
+private:
+    friend class FHttpRequestParser;
+
+    FUtf8StringView View(const FHttpSpan& Span) const
+    {
+        return FUtf8StringView(reinterpret_cast<const UTF8CHAR*>(Data.GetData() + Span.Offset), Span.Len);
+    }
+
+    TArray<uint8> Data;
+    FHttpSpan Method;
+    FHttpSpan Path;
+    FHttpSpan Query;
+    FHttpSpan Version;
+    FHttpSpan Body;
+    TArray<TPair<FHttpSpan, FHttpSpan>, TInlineAllocator<16>> Headers;
+};
+
+enum class EHttpParseResult : uint8
+{
+    NeedMore,
+    Complete,
+    Error
+};
+
+/**
+ * Incremental HTTP/1.x request parser operating on the raw receive buffer.
+ * Call Parse each time bytes are appended; it resumes where it stopped,
+ * honours Content-Length and chunked bodies across any number of reads
+ * (chunks are de-framed in place) and rejects oversized input as soon as
+ * the limit is known to be exceeded.
+ */
+class FHttpRequestParser
+{
+public:
+    FHttpRequestParser(int32 InMaxHeaderBytes, int32 InMaxBodyBytes);
+
+    /** Advance over the bytes at the front of Buffer */
+    EHttpParseResult Parse(TArray<uint8>& Buffer);
+
+    /**
+     * After Complete: move the request out of Buffer, leaving any pipelined
+     * bytes behind for the next request, and reset for the next parse.
+     */
+    TSharedRef<FHttpRequest> TakeRequest(TArray<uint8>& Buffer);
+
+    /** HTTP status describing the last Error (400, 413, 431, 501) */
+    int32 GetErrorStatus() const { return ErrorStatus; }
+
+    /** Maximum body size accepted */
+    int32 GetMaxBodyBytes() const { return MaxBodyBytes; }
+
+    void Reset();
+
+private:
+    enum class EState : uint8
+    {
+        Headers,
+        FixedBody,
+        ChunkSize,
+        ChunkData,
+        ChunkDataEnd,
+        Trailers,
+        Complete,
+        Error
+    };
+
+    /** Parse request line and header fields once the header block is complete */
+    bool ParseHeaderBlock(const uint8* Data, int32 HeaderEnd);
+
+    /** Find CRLF at or after From, INDEX_NONE if not yet received */
+    static int32 FindCrlf(const uint8* Data, int32 From, int32 Num);
+
+    EHttpParseResult Fail(int32 Status);
+
+    int32 MaxHeaderBytes;
+    int32 MaxBodyBytes;
+
+    EState State = EState::Headers;
+    int32 ScanPos = 0;
+    int32 BodyStart = 0;
+    int32 ReadPos = 0;
+    int32 WritePos = 0;
+    int64 ChunkRemaining = 0;
+    int64 ContentLength = 0;
+    int32 ErrorStatus = 0;
+
+    TSharedRef<FHttpRequest> Pending;
+};
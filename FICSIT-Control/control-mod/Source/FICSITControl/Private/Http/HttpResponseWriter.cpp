@@ -0,0 +1,141 @@
+#include "HttpResponseWriter.h"
+#include "Misc/ScopeLock.h"
+
+// Sent on every response; the web app calls the API cross-origin
+static constexpr FAnsiStringView CorsHeaders =
+    "Access-Control-Allow-Origin: *\r\n"
+    "Access-Control-Allow-Headers: Content-Type, Authorization\r\n"
+    "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n";
+
+// Buffers kept for reuse, and the largest one worth keeping
+static constexpr int32 MaxPooledBuffers = 32;
+static constexpr int32 MaxPooledCapacity = 256 * 1024;
+
+// Initial reservation: headers plus a typical JSON body
+static constexpr int32 InitialCapacity = 1024;
+
+static FCriticalSection PoolMutex;
+static TArray<TArray<uint8>> BufferPool;
+
+static TArray<uint8> AcquireBuffer()
+{
+    {
+        FScopeLock Lock(&PoolMutex);
+        if (BufferPool.Num() > 0)
+        {
+            return BufferPool.Pop(false);
+        }
+    }
+
+    TArray<uint8> Fresh;
+    Fresh.Reserve(InitialCapacity);
+    return Fresh;
+}
+
+static void ReleaseBuffer(TArray<uint8>&& Buffer)
+{
+    if (Buffer.Max() == 0 || Buffer.Max() > MaxPooledCapacity)
+    {
+        return;
+    }
+
+    Buffer.Reset();
+    FScopeLock Lock(&PoolMutex);
+    if (BufferPool.Num() < MaxPooledBuffers)
+    {
+        BufferPool.Add(MoveTemp(Buffer));
+    }
+}
+
+FHttpResponseWriter::FHttpResponseWriter(int32 StatusCode, FAnsiStringView StatusText)
+    : Buffer(AcquireBuffer())
+{
+    AppendAscii(Buffer, "HTTP/1.1 ");
+    AppendDecimal(Buffer, StatusCode);
+    Buffer.Add(' ');
+    AppendAscii(Buffer, StatusText);
+    AppendAscii(Buffer, "\r\n");
+    AppendAscii(Buffer, CorsHeaders);
+}
+
+FHttpResponseWriter::~FHttpResponseWriter()
+{
+    ReleaseBuffer(MoveTemp(Buffer));
+}
+
+void FHttpResponseWriter::AddHeader(FAnsiStringView Name, FAnsiStringView Value)
+{
+    AppendAscii(Buffer, Name);
+    AppendAscii(Buffer, ": ");
+    AppendAscii(Buffer, Value);
+    AppendAscii(Buffer, "\r\n");
+}
+
+void FHttpResponseWriter::AddHeader(FAnsiStringView Name, int64 Value)
+{
+    AppendAscii(Buffer, Name);
+    AppendAscii(Buffer, ": ");
+    AppendDecimal(Buffer, Value);
+    AppendAscii(Buffer, "\r\n");
+}
+
+void FHttpResponseWriter::AddRawHeaders(FAnsiStringView Lines)
+{
+    AppendAscii(Buffer, Lines);
+}
+
+void FHttpResponseWriter::Finish(const FString& Body)
+{
+    const int32 BodyLen = Body.IsEmpty() ? 0 : FPlatformString::ConvertedLength<UTF8CHAR>(*Body, Body.Len());
+    AddHeader("Content-Length", BodyLen);
+    AppendAscii(Buffer, "\r\n");
+    AppendUtf8(Buffer, Body);
+}
+
+void FHttpResponseWriter::Finish(TArrayView<const uint8> Body)
+{
+    AddHeader("Content-Length", Body.Num());
+    AppendAscii(Buffer, "\r\n");
+    Buffer.Append(Body.GetData(), Body.Num());
+}
+
+void FHttpResponseWriter::FinishStreaming()
+{
+    AppendAscii(Buffer, "\r\n");
+}
+
+void FHttpResponseWriter::AppendAscii(TArray<uint8>& Out, FAnsiStringView Text)
+{
+    Out.Append(reinterpret_cast<const uint8*>(Text.GetData()), Text.Len());
+}
+
+void FHttpResponseWriter::AppendDecimal(TArray<uint8>& Out, int64 Value)
+{
+    uint8 Digits[20];
+    int32 Count = 0;
+    uint64 Magnitude = Value < 0 ? 0 - static_cast<uint64>(Value) : static_cast<uint64>(Value);
+    do
+    {
+        Digits[Count++] = static_cast<uint8>('0' + Magnitude % 10);
+        Magnitude /= 10;
+    }
+    while (Magnitude != 0);
+
+    if (Value < 0)
+    {
+        Out.Add('-');
+    }
+    while (Count > 0)
+    {
+        Out.Add(Digits[--Count]);
+    }
+}
+
+void FHttpResponseWriter::AppendUtf8(TArray<uint8>& Out, const FString& Text)
+{
+    if (Text.IsEmpty()) return;
+
+    const int32 Len = FPlatformString::ConvertedLength<UTF8CHAR>(*Text, Text.Len());
+    const int32 Start = Out.AddUninitialized(Len);
+    FPlatformString::Convert(reinterpret_cast<UTF8CHAR*>(Out.GetData() + Start), Len, *Text, Text.Len());
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/StringView.h"
+
+/**
+ * Builds one HTTP response into a single contiguous UTF-8 buffer.
+ * Buffers are recycled through a small process-wide pool, the CORS block is
+ * a precomputed constant and the body is transcoded straight into place, so
+ * a steady stream of responses allocates nothing per request.
+ */
+class FHttpResponseWriter
+{
+public:
+    FHttpResponseWriter(int32 StatusCode, FAnsiStringView StatusText);
+    ~FHttpResponseWriter();
+
+    FHttpResponseWriter(const FHttpResponseWriter&) = delete;
+    FHttpResponseWriter& operator=(const FHttpResponseWriter&) = delete;
+
+    /** Append a header line */
+    void AddHeader(FAnsiStringView Name, FAnsiStringView Value);
+    void AddHeader(FAnsiStringView Name, int64 Value);
+
+    /** Append preformatted header lines ("Name: value\r\n" each) */
+    void AddRawHeaders(FAnsiStringView Lines);
+
+    /** Add Content-Length, end the header block and append the body */
+    void Finish(const FString& Body);
+    void Finish(TArrayView<const uint8> Body);
+
+    /** End the header block without Content-Length (body delimited by close) */
+    void FinishStreaming();
+
+    /** The encoded response; hand it to FHttpConnection::Write to avoid a copy */
+    TArray<uint8>& GetBuffer() { return Buffer; }
+
+    /** Append ASCII text to a byte buffer */
+    static void AppendAscii(TArray<uint8>& Out, FAnsiStringView Text);
+
+    /** Append a decimal integer without going through FString */
+    static void AppendDecimal(TArray<uint8>& Out, int64 Value);
+
+    /** Transcode TCHAR text to UTF-8 directly into Out */
+    static void AppendUtf8(TArray<uint8>& Out, const FString& Text);
+
+private:
+    TArray<uint8> Buffer;
+};
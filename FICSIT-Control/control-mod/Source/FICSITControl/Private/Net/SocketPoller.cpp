@@ -0,0 +1,172 @@
+#include "SocketPoller.h"
+#include "SocketSubsystem.h"
+#include "IPAddress.h"
+
+// Sockets on these platforms are FSocketBSD (or our own AF_UNIX wrapper)
+#define CONTROL_NATIVE_POLL (PLATFORM_WINDOWS || PLATFORM_UNIX)
+
+#if CONTROL_NATIVE_POLL
+#include "BSDSockets/SocketsBSD.h"
+#include "UnixDomainSocket.h"
+#if PLATFORM_WINDOWS
+#include "Windows/AllowWindowsPlatformTypes.h"
+#include <winsock2.h>
+#include "Windows/HideWindowsPlatformTypes.h"
+#else
+#include <poll.h>
+#endif
+#endif
+
+DEFINE_LOG_CATEGORY_STATIC(LogSocketPoller, Log, All);
+
+#if CONTROL_NATIVE_POLL
+#if PLATFORM_WINDOWS
+using FNativePollFd = WSAPOLLFD;
+static int32 NativePoll(FNativePollFd* Fds, int32 Count, int32 TimeoutMs) { return WSAPoll(Fds, Count, TimeoutMs); }
+#else
+using FNativePollFd = pollfd;
+static int32 NativePoll(FNativePollFd* Fds, int32 Count, int32 TimeoutMs) { return poll(Fds, Count, TimeoutMs); }
+#endif
+
+static SOCKET GetNativeSocket(FSocket* Socket)
+{
+#if PLATFORM_UNIX
+    // Wraps its own descriptor rather than going through the subsystem
+    if (Socket->GetProtocol() == FUnixDomainSocket::ProtocolName)
+    {
+        return static_cast<FUnixDomainSocket*>(Socket)->GetDescriptor();
+    }
+#endif
+    return static_cast<FSocketBSD*>(Socket)->GetNativeSocket();
+}
+#endif
+
+struct FSocketPoller::FNativeSet
+{
+#if CONTROL_NATIVE_POLL
+    /** The wake socket is always entry 0 */
+    TArray<FNativePollFd> Fds;
+#endif
+};
+
+FSocketPoller::FSocketPoller()
+    : Native(MakeUnique<FNativeSet>())
+{
+}
+
+FSocketPoller::~FSocketPoller()
+{
+    Shutdown();
+}
+
+bool FSocketPoller::Init()
+{
+#if CONTROL_NATIVE_POLL
+    if (WakeSocket) return true;
+
+    ISocketSubsystem* Subsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+    FSocket* Socket = Subsystem->CreateSocket(NAME_DGram, TEXT("ControlReactorWake"), FNetworkProtocolTypes::IPv4);
+    if (!Socket)
+    {
+        UE_LOG(LogSocketPoller, Warning, TEXT("Could not create the wake socket; the reactor will sweep on a timer"));
+        return false;
+    }
+
+    // Bound to an ephemeral loopback port, then addressed to itself
+    TSharedRef<FInternetAddr> Addr = Subsystem->CreateInternetAddr(FNetworkProtocolTypes::IPv4);
+    Addr->SetLoopbackAddress();
+    Addr->SetPort(0);
+    if (!Socket->SetNonBlocking(true) || !Socket->Bind(*Addr))
+    {
+        UE_LOG(LogSocketPoller, Warning, TEXT("Could not bind the wake socket; the reactor will sweep on a timer"));
+        Subsystem->DestroySocket(Socket);
+        return false;
+    }
+    Socket->GetAddress(*Addr);
+    Addr->SetLoopbackAddress();
+
+    WakeAddr = Addr;
+    WakeSocket = Socket;
+    bWakePending = false;
+    Reset();
+    return true;
+#else
+    return false;
+#endif
+}
+
+void FSocketPoller::Shutdown()
+{
+    if (WakeSocket)
+    {
+        WakeSocket->Close();
+        ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(WakeSocket);
+        WakeSocket = nullptr;
+    }
+    WakeAddr.Reset();
+}
+
+void FSocketPoller::Reset()
+{
+#if CONTROL_NATIVE_POLL
+    Native->Fds.Reset();
+    if (WakeSocket)
+    {
+        FNativePollFd& Fd = Native->Fds.AddZeroed_GetRef();
+        Fd.fd = GetNativeSocket(WakeSocket);
+        Fd.events = POLLIN;
+    }
+#endif
+}
+
+void FSocketPoller::Add(FSocket* Socket, bool bRead, bool bWrite)
+{
+#if CONTROL_NATIVE_POLL
+    FNativePollFd& Fd = Native->Fds.AddZeroed_GetRef();
+    Fd.fd = GetNativeSocket(Socket);
+    Fd.events = static_cast<decltype(Fd.events)>((bRead ? POLLIN : 0) | (bWrite ? POLLOUT : 0));
+#endif
+}
+
+bool FSocketPoller::Wait(int32 TimeoutMs)
+{
+#if CONTROL_NATIVE_POLL
+    if (!WakeSocket) return false;
+
+    const int32 Result = NativePoll(Native->Fds.GetData(), Native->Fds.Num(), FMath::Max(TimeoutMs, 0));
+    if (Result < 0)
+    {
+        return false;
+    }
+    if (Result > 0 && Native->Fds[0].revents != 0)
+    {
+        DrainWakes();
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void FSocketPoller::Wake()
+{
+    // One datagram per wait is enough; later wakes ride on it
+    if (!WakeSocket || bWakePending.Exchange(true)) return;
+
+    const uint8 Byte = 0;
+    int32 BytesSent = 0;
+    WakeSocket->SendTo(&Byte, 1, BytesSent, *WakeAddr);
+}
+
+void FSocketPoller::DrainWakes()
+{
+    uint8 Buffer[64];
+    int32 BytesRead = 0;
+    while (WakeSocket->Recv(Buffer, sizeof(Buffer), BytesRead) && BytesRead > 0)
+    {
+    }
+
+    // Cleared after the drain: a wake that lands in between leaves its
+    // datagram queued, so the next wait returns at once instead of missing it
+    bWakePending = false;
+}
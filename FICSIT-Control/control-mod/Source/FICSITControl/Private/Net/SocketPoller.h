@@ -0,0 +1,59 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Sockets.h"
+
+class FInternetAddr;
+
+/**
+ * Readiness wait over many sockets for the reactor's idle path.
+ * FSocket::Wait covers one socket at a time, so this polls the native
+ * descriptors together (poll, or WSAPoll on Windows) along with a loopback
+ * datagram socket that Wake writes to, which lets other threads cut a wait
+ * short. Where sockets are not BSD sockets Init fails and the caller keeps
+ * sweeping on a timer.
+ */
+class FSocketPoller
+{
+public:
+    FSocketPoller();
+    ~FSocketPoller();
+
+    /** Create the wake socket. Returns false if readiness waits are unavailable. */
+    bool Init();
+
+    /** Release the wake socket */
+    void Shutdown();
+
+    /** Whether Init succeeded */
+    bool IsAvailable() const { return WakeSocket != nullptr; }
+
+    /** Start a new wait set (reactor thread) */
+    void Reset();
+
+    /** Wait for Socket to become readable and/or writable (reactor thread) */
+    void Add(FSocket* Socket, bool bRead, bool bWrite);
+
+    /**
+     * Block until a socket in the set is ready, Wake is called, or TimeoutMs
+     * passes (reactor thread). Returns false if the wait itself failed.
+     */
+    bool Wait(int32 TimeoutMs);
+
+    /** Cut the current or next Wait short (any thread) */
+    void Wake();
+
+private:
+    /** Consume queued wake datagrams */
+    void DrainWakes();
+
+    /** Native pollfd array, defined where the platform headers are */
+    struct FNativeSet;
+    TUniquePtr<FNativeSet> Native;
+
+    FSocket* WakeSocket = nullptr;
+    TSharedPtr<FInternetAddr> WakeAddr;
+
+    /** Set between a Wake and the wait that consumes it, so wakes are sent once */
+    TAtomic<bool> bWakePending { false };
+};
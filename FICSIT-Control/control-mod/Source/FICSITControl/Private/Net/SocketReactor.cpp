@@ -0,0 +1,627 @@
+#include "SocketReactor.h"
+#include "UnixDomainSocket.h"
+#include "SocketSubsystem.h"
+#include "Common/TcpSocketBuilder.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+#include "Misc/QueuedThreadPool.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSocketReactor, Log, All);
+
+// Idle sweeps before the loop backs off from the short wait to the long one
+static constexpr int32 ShortIdleSweeps = 16;
+static constexpr uint32 ShortIdleWaitMs = 1;
+static constexpr uint32 LongIdleWaitMs = 5;
+
+// Longest readiness wait: one timer wheel tick, so deadlines still fire on time
+static constexpr int32 MaxReadinessWaitMs = 100;
+
+// Bytes pulled from one socket per sweep, so one busy peer cannot starve the rest
+static constexpr int32 MaxReadPerSweep = 256 * 1024;
+
+/** Adapts a lambda to the thread pool's work interface */
+class FReactorWork : public IQueuedWork
+{
+public:
+    explicit FReactorWork(TUniqueFunction<void()>&& InWork)
+        : Work(MoveTemp(InWork))
+    {
+    }
+
+    virtual void DoThreadedWork() override
+    {
+        Work();
+        delete this;
+    }
+
+    virtual void Abandon() override
+    {
+        delete this;
+    }
+
+private:
+    TUniqueFunction<void()> Work;
+};
+
+FSocketReactor::FSocketReactor()
+{
+}
+
+FSocketReactor::~FSocketReactor()
+{
+    Shutdown();
+}
+
+bool FSocketReactor::Start(int32 NumWorkers)
+{
+    if (Thread) return true;
+
+    WorkerPool = FQueuedThreadPool::Allocate();
+    if (!WorkerPool->Create(FMath::Max(1, NumWorkers), 128 * 1024, TPri_Normal, TEXT("ControlWorkers")))
+    {
+        UE_LOG(LogSocketReactor, Error, TEXT("Failed to create worker pool"));
+        delete WorkerPool;
+        WorkerPool = nullptr;
+        return false;
+    }
+
+    WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+    Poller.Init();
+    bStopping = false;
+
+    Thread = FRunnableThread::Create(this, TEXT("ControlSocketReactor"), 0, TPri_AboveNormal);
+    if (!Thread)
+    {
+        UE_LOG(LogSocketReactor, Error, TEXT("Failed to create reactor thread"));
+        Shutdown();
+        return false;
+    }
+
+    UE_LOG(LogSocketReactor, Log, TEXT("Socket reactor started with %d workers"), FMath::Max(1, NumWorkers));
+    return true;
+}
+
+void FSocketReactor::Shutdown()
+{
+    if (Thread)
+    {
+        Stop();
+        Thread->WaitForCompletion();
+        delete Thread;
+        Thread = nullptr;
+    }
+
+    // Thread is gone, so the containers are ours again. This is the last
+    // drain: RunOnReactorThread posts nothing once bStopping is set.
+    {
+        FScopeLock Lock(&PendingOpsMutex);
+        DrainPendingOps();
+    }
+    CloseAll();
+
+    // Delayed work is dropped with the pool; its owners flush on their own shutdown
+    DelayedWork.Empty();
+    IncomingDelayedWork.Empty();
+
+    if (WorkerPool)
+    {
+        WorkerPool->Destroy();
+        delete WorkerPool;
+        WorkerPool = nullptr;
+    }
+
+    if (WakeEvent)
+    {
+        FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+        WakeEvent = nullptr;
+    }
+    Poller.Shutdown();
+}
+
+int32 FSocketReactor::AddListener(const FIPv4Endpoint& Endpoint, const FString& Description,
+    FOnAccepted Handler)
+{
+    FSocket* ListenSocket = FTcpSocketBuilder(*Description)
+        .AsNonBlocking()
+        .AsReusable(false)
+        .BoundToEndpoint(Endpoint)
+        .Listening(128)
+        .Build();
+
+    if (!ListenSocket)
+    {
+        UE_LOG(LogSocketReactor, Error, TEXT("Failed to listen on %s"), *Endpoint.ToString());
+        return INDEX_NONE;
+    }
+
+    return AdoptListener(ListenSocket, Description, MoveTemp(Handler));
+}
+
+int32 FSocketReactor::AddLocalListener(const FString& Path, int32 FileMode, const FString& Description,
+    FOnAccepted Handler)
+{
+#if PLATFORM_UNIX
+    FSocket* ListenSocket = FUnixDomainSocket::CreateListener(Path, FileMode, Description);
+    if (!ListenSocket)
+    {
+        UE_LOG(LogSocketReactor, Error, TEXT("Failed to listen on %s"), *Path);
+        return INDEX_NONE;
+    }
+
+    return AdoptListener(ListenSocket, Description, MoveTemp(Handler));
+#else
+    UE_LOG(LogSocketReactor, Warning, TEXT("Unix domain sockets are not supported on this platform (%s)"), *Path);
+    return INDEX_NONE;
+#endif
+}
+
+int32 FSocketReactor::AdoptListener(FSocket* ListenSocket, const FString& Description, FOnAccepted Handler)
+{
+    FListener Listener;
+    Listener.Socket = ListenSocket;
+    Listener.Description = Description;
+    Listener.Handler = MoveTemp(Handler);
+
+    int32 Id = INDEX_NONE;
+    const bool bAdded = RunOnReactorThread([this, &Listener, &Id]()
+    {
+        Listener.Id = NextListenerId++;
+        Id = Listener.Id;
+        Listeners.Add(MoveTemp(Listener));
+    });
+
+    if (!bAdded)
+    {
+        DestroySocket(ListenSocket);
+    }
+    return Id;
+}
+
+void FSocketReactor::RemoveListener(int32 ListenerId)
+{
+    if (ListenerId == INDEX_NONE) return;
+
+    RunOnReactorThread([this, ListenerId]()
+    {
+        for (int32 i = Listeners.Num() - 1; i >= 0; --i)
+        {
+            if (Listeners[i].Id == ListenerId)
+            {
+                DestroySocket(Listeners[i].Socket);
+                Listeners.RemoveAtSwap(i);
+            }
+        }
+
+        for (int32 i = Connections.Num() - 1; i >= 0; --i)
+        {
+            if (Connections[i].ListenerId == ListenerId)
+            {
+                RetireConnection(i, EServiceResult::Close);
+            }
+        }
+    });
+}
+
+FReactorStats FSocketReactor::GetStats() const
+{
+    FReactorStats Stats;
+    Stats.Connections = NumConnections.Load();
+    Stats.Accepted = NumAccepted.Load();
+    Stats.Refused = NumRefused.Load();
+    Stats.TimedOut = NumTimedOut.Load();
+    return Stats;
+}
+
+void FSocketReactor::QueueWork(TUniqueFunction<void()> Work, EQueuedWorkPriority Priority)
+{
+    if (WorkerPool)
+    {
+        WorkerPool->AddQueuedWork(new FReactorWork(MoveTemp(Work)), Priority);
+    }
+}
+
+void FSocketReactor::QueueWorkAfter(double DelaySeconds, TUniqueFunction<void()> Work, EQueuedWorkPriority Priority)
+{
+    if (!WorkerPool) return;
+
+    FDelayedWork Delayed;
+    Delayed.Due = FPlatformTime::Seconds() + FMath::Max(DelaySeconds, 0.0);
+    Delayed.Work = MoveTemp(Work);
+    Delayed.Priority = Priority;
+    IncomingDelayedWork.Enqueue(MoveTemp(Delayed));
+
+    // The thread may be blocked past the new due time
+    Wake();
+}
+
+double FSocketReactor::QueueDueWork(double Now)
+{
+    FDelayedWork Incoming;
+    while (IncomingDelayedWork.Dequeue(Incoming))
+    {
+        DelayedWork.Add(MoveTemp(Incoming));
+    }
+
+    double NextDue = 0.0;
+    for (int32 i = DelayedWork.Num() - 1; i >= 0; --i)
+    {
+        FDelayedWork& Delayed = DelayedWork[i];
+        if (Delayed.Due <= Now)
+        {
+            QueueWork(MoveTemp(Delayed.Work), Delayed.Priority);
+            DelayedWork.RemoveAtSwap(i);
+        }
+        else if (NextDue <= 0.0 || Delayed.Due < NextDue)
+        {
+            NextDue = Delayed.Due;
+        }
+    }
+    return NextDue;
+}
+
+void FSocketReactor::Wake()
+{
+    if (Poller.IsAvailable())
+    {
+        Poller.Wake();
+    }
+    else if (WakeEvent)
+    {
+        WakeEvent->Trigger();
+    }
+}
+
+ESocketIoResult FSocketReactor::RecvAvailable(FSocket* Socket, TArray<uint8>& Buffer, int32 MaxBytes)
+{
+    int32 Total = 0;
+    while (Total < MaxBytes)
+    {
+        const int32 Offset = Buffer.Num();
+        const int32 ChunkSize = FMath::Min(16384, MaxBytes - Total);
+        Buffer.AddUninitialized(ChunkSize);
+
+        int32 BytesRead = 0;
+        const bool bOk = Socket->Recv(Buffer.GetData() + Offset, ChunkSize, BytesRead);
+        Buffer.SetNum(Offset + FMath::Max(BytesRead, 0), false);
+
+        // Streaming sockets report would-block as success with zero bytes
+        // and an orderly shutdown as failure
+        if (!bOk)
+        {
+            return ESocketIoResult::Closed;
+        }
+        if (BytesRead <= 0)
+        {
+            return Total > 0 ? ESocketIoResult::Ok : ESocketIoResult::WouldBlock;
+        }
+
+        Total += BytesRead;
+        if (BytesRead < ChunkSize)
+        {
+            break;
+        }
+    }
+    return ESocketIoResult::Ok;
+}
+
+ESocketIoResult FSocketReactor::SendSome(FSocket* Socket, const uint8* Data, int32 Count, int32& OutBytesSent)
+{
+    OutBytesSent = 0;
+    if (Count <= 0) return ESocketIoResult::Ok;
+
+    int32 BytesSent = 0;
+    if (!Socket->Send(Data, Count, BytesSent))
+    {
+        const ESocketErrors Error = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode();
+        return Error == SE_EWOULDBLOCK ? ESocketIoResult::WouldBlock : ESocketIoResult::Closed;
+    }
+
+    OutBytesSent = FMath::Max(BytesSent, 0);
+    return OutBytesSent > 0 ? ESocketIoResult::Ok : ESocketIoResult::WouldBlock;
+}
+
+void FSocketReactor::DestroySocket(FSocket* Socket)
+{
+    if (Socket)
+    {
+        Socket->Close();
+#if PLATFORM_UNIX
+        // Not created by the socket subsystem, so not its to destroy
+        if (Socket->GetProtocol() == FUnixDomainSocket::ProtocolName)
+        {
+            delete Socket;
+            return;
+        }
+#endif
+        ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+    }
+}
+
+uint32 FSocketReactor::Run()
+{
+    int32 IdleSweeps = 0;
+
+    while (!bStopping)
+    {
+        DrainPendingOps();
+
+        const double Now = FPlatformTime::Seconds();
+        const double NextDue = QueueDueWork(Now);
+
+        bool bActivity = AcceptPending();
+        bActivity |= ServiceConnections(Now);
+
+        if (bActivity)
+        {
+            IdleSweeps = 0;
+            continue;
+        }
+
+        if (Poller.IsAvailable())
+        {
+            WaitForReadiness(NextDue);
+            continue;
+        }
+
+        ++IdleSweeps;
+        WakeEvent->Wait(IdleSweeps < ShortIdleSweeps ? ShortIdleWaitMs : LongIdleWaitMs);
+    }
+
+    return 0;
+}
+
+void FSocketReactor::Stop()
+{
+    bStopping = true;
+    Wake();
+}
+
+bool FSocketReactor::RunOnReactorThread(TFunction<void()> Op)
+{
+    if (!Thread || FPlatformTLS::GetCurrentThreadId() == Thread->GetThreadID())
+    {
+        Op();
+        return true;
+    }
+
+    FEvent* Done = FPlatformProcess::GetSynchEventFromPool(false);
+    {
+        // Shutdown's last drain takes the same lock after setting bStopping,
+        // so an op posted here is always run by the thread or by that drain
+        FScopeLock Lock(&PendingOpsMutex);
+        if (bStopping)
+        {
+            FPlatformProcess::ReturnSynchEventToPool(Done);
+            return false;
+        }
+        PendingOps.Enqueue([&Op, Done]()
+        {
+            Op();
+            Done->Trigger();
+        });
+    }
+    Wake();
+    Done->Wait();
+    FPlatformProcess::ReturnSynchEventToPool(Done);
+    return true;
+}
+
+void FSocketReactor::DrainPendingOps()
+{
+    TFunction<void()> Op;
+    while (PendingOps.Dequeue(Op))
+    {
+        Op();
+    }
+}
+
+bool FSocketReactor::AcceptPending()
+{
+    bool bAccepted = false;
+
+    for (FListener& Listener : Listeners)
+    {
+        bool bHasPending = false;
+        while (Listener.Socket->HasPendingConnection(bHasPending) && bHasPending)
+        {
+            FSocket* Client = Listener.Socket->Accept(Listener.Description);
+            if (!Client)
+            {
+                break;
+            }
+
+            bAccepted = true;
+
+            // Global cap across both servers, ahead of their own per-port limits
+            if (MaxConnections > 0 && Connections.Num() >= MaxConnections)
+            {
+                ++NumRefused;
+                DestroySocket(Client);
+                continue;
+            }
+
+            Client->SetNonBlocking(true);
+            Client->SetNoDelay(true);
+
+            TSharedPtr<IReactorConnection> Connection;
+            if (Listener.Handler.IsBound())
+            {
+                Connection = Listener.Handler.Execute(Client);
+            }
+
+            if (Connection.IsValid())
+            {
+                ++NumAccepted;
+                Connections.Add({ Connection, Listener.Id });
+                NumConnections = Connections.Num();
+                ArmDeadline(Connections.Last());
+            }
+            else
+            {
+                ++NumRefused;
+                DestroySocket(Client);
+            }
+        }
+    }
+
+    return bAccepted;
+}
+
+bool FSocketReactor::ServiceConnections(double Now)
+{
+    bool bActivity = false;
+
+    for (int32 i = Connections.Num() - 1; i >= 0; --i)
+    {
+        const EServiceResult Result = Connections[i].Connection->Service(Now);
+        switch (Result)
+        {
+        case EServiceResult::Idle:
+            ArmDeadline(Connections[i]);
+            break;
+        case EServiceResult::Busy:
+            ArmDeadline(Connections[i]);
+            bActivity = true;
+            break;
+        case EServiceResult::Close:
+        case EServiceResult::Upgrade:
+            RetireConnection(i, Result);
+            bActivity = true;
+            break;
+        }
+    }
+
+    bActivity |= ExpireDeadlines(Now);
+    return bActivity;
+}
+
+void FSocketReactor::ArmDeadline(FConnectionEntry& Entry)
+{
+    // Later deadlines ride on the entry already filed; it re-arms when it fires
+    const double Deadline = Entry.Connection->GetDeadline();
+    if (Deadline > 0.0 && (Entry.ArmedDeadline <= 0.0 || Deadline < Entry.ArmedDeadline))
+    {
+        Entry.ArmedDeadline = Deadline;
+        Deadlines.Schedule(Deadline, Entry.Connection);
+    }
+}
+
+bool FSocketReactor::ExpireDeadlines(double Now)
+{
+    TArray<TSharedPtr<IReactorConnection>> Expired;
+    Deadlines.Advance(Now, Expired);
+
+    bool bDropped = false;
+    for (const TSharedPtr<IReactorConnection>& Connection : Expired)
+    {
+        const int32 Index = Connections.IndexOfByPredicate(
+            [&Connection](const FConnectionEntry& Entry) { return Entry.Connection == Connection; });
+        if (Index == INDEX_NONE)
+        {
+            continue;
+        }
+
+        Connections[Index].ArmedDeadline = 0.0;
+        const double Deadline = Connection->GetDeadline();
+        if (Deadline <= 0.0 || Deadline > Now)
+        {
+            // Pushed back (or cleared) since it was filed
+            ArmDeadline(Connections[Index]);
+            continue;
+        }
+
+        const EServiceResult Result = Connection->OnDeadline(Now);
+        if (Result == EServiceResult::Close || Result == EServiceResult::Upgrade)
+        {
+            if (Result == EServiceResult::Close)
+            {
+                ++NumTimedOut;
+            }
+            RetireConnection(Index, Result);
+            bDropped = true;
+        }
+        else
+        {
+            ArmDeadline(Connections[Index]);
+        }
+    }
+
+    return bDropped;
+}
+
+void FSocketReactor::WaitForReadiness(double NextDue)
+{
+    Poller.Reset();
+    for (const FListener& Listener : Listeners)
+    {
+        Poller.Add(Listener.Socket, true, false);
+    }
+
+    int32 TimeoutMs = MaxReadinessWaitMs;
+    for (const FConnectionEntry& Entry : Connections)
+    {
+        if (FSocket* Socket = Entry.Connection->GetSocket())
+        {
+            const bool bRead = Entry.Connection->WantsRead();
+            const bool bWrite = Entry.Connection->WantsWrite();
+            if (bRead || bWrite)
+            {
+                Poller.Add(Socket, bRead, bWrite);
+            }
+        }
+        else
+        {
+            // Nothing to wait on for this one, so come back as often as the sweep would
+            TimeoutMs = static_cast<int32>(LongIdleWaitMs);
+        }
+    }
+
+    if (NextDue > 0.0)
+    {
+        const double UntilDue = NextDue - FPlatformTime::Seconds();
+        TimeoutMs = FMath::Min(TimeoutMs, FMath::Max(FMath::CeilToInt(UntilDue * 1000.0), 0));
+    }
+
+    if (!Poller.Wait(TimeoutMs))
+    {
+        WakeEvent->Wait(LongIdleWaitMs);
+    }
+}
+
+void FSocketReactor::RetireConnection(int32 Index, EServiceResult Result)
+{
+    FConnectionEntry& Entry = Connections[Index];
+
+    // An upgrade keeps the slot, the socket and the listener; only the protocol changes
+    if (Result == EServiceResult::Upgrade)
+    {
+        if (TSharedPtr<IReactorConnection> Next = Entry.Connection->TakeUpgrade())
+        {
+            Entry.Connection = MoveTemp(Next);
+            Entry.ArmedDeadline = 0.0;
+            ArmDeadline(Entry);
+            return;
+        }
+    }
+
+    Entry.Connection->OnClosed();
+    Connections.RemoveAtSwap(Index);
+    NumConnections = Connections.Num();
+}
+
+void FSocketReactor::CloseAll()
+{
+    for (FConnectionEntry& Entry : Connections)
+    {
+        Entry.Connection->OnClosed();
+    }
+    Connections.Empty();
+    NumConnections = 0;
+    Deadlines.Reset();
+
+    for (FListener& Listener : Listeners)
+    {
+        DestroySocket(Listener.Socket);
+    }
+    Listeners.Empty();
+}
@@ -0,0 +1,245 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "Containers/Queue.h"
+#include "Interfaces/IPv4/IPv4Endpoint.h"
+#include "Sockets.h"
+#include "Misc/IQueuedWork.h"
+#include "TimerWheel.h"
+#include "SocketPoller.h"
+
+class FRunnableThread;
+class FQueuedThreadPool;
+class FEvent;
+
+/** Outcome of one non-blocking service pass over a connection */
+enum class EServiceResult : uint8
+{
+    /** Nothing to read or write */
+    Idle,
+    /** Bytes were moved or work was dispatched */
+    Busy,
+    /** Close and destroy the socket */
+    Close,
+    /** Replace the connection with the one returned by TakeUpgrade (same socket) */
+    Upgrade
+};
+
+/** Outcome of a single non-blocking socket read or write */
+enum class ESocketIoResult : uint8
+{
+    Ok,
+    WouldBlock,
+    Closed
+};
+
+/**
+ * A client socket owned by the reactor thread.
+ * Service is only ever called from the reactor thread and must not block.
+ */
+class IReactorConnection
+{
+public:
+    virtual ~IReactorConnection() = default;
+
+    /** Read what is available, parse, dispatch and flush pending writes */
+    virtual EServiceResult Service(double Now) = 0;
+
+    /** Called once on the reactor thread when the connection is dropped */
+    virtual void OnClosed() = 0;
+
+    /**
+     * Absolute time (FPlatformTime seconds) by which the connection must make
+     * progress, or 0 for none. Read on the reactor thread after each Service.
+     */
+    virtual double GetDeadline() const { return 0.0; }
+
+    /** The deadline passed without being pushed back. Busy keeps the connection. */
+    virtual EServiceResult OnDeadline(double Now) { return EServiceResult::Close; }
+
+    /** After Service returns Upgrade: the connection that takes over the socket */
+    virtual TSharedPtr<IReactorConnection> TakeUpgrade() { return nullptr; }
+
+    /** The socket the reactor waits on between sweeps, or nullptr to be swept on a timer */
+    virtual FSocket* GetSocket() const { return nullptr; }
+
+    /**
+     * What the idle wait watches the socket for (reactor thread): readable
+     * while Service would read from it, writable while bytes are waiting for
+     * the socket to accept them. A connection that wants neither is woken by
+     * Wake or its deadline.
+     */
+    virtual bool WantsRead() const { return true; }
+    virtual bool WantsWrite() const { return false; }
+};
+
+/** Counters published by the reactor (read from any thread) */
+struct FReactorStats
+{
+    int32 Connections = 0;
+    int64 Accepted = 0;
+    int64 Refused = 0;
+    int64 TimedOut = 0;
+};
+
+/**
+ * Single network thread that owns the listening and client sockets of the
+ * HTTP and WebSocket servers. All sockets are non-blocking and swept in one
+ * loop; fully parsed work is handed to a small dedicated worker pool so no
+ * socket ever parks a thread of the engine's shared pool.
+ *
+ * Once a sweep finds nothing to do, the thread blocks in FSocketPoller until
+ * a socket is ready, Wake is called, or the next timer wheel tick is due.
+ * Where readiness waits are unavailable it backs off on an event instead.
+ */
+class FSocketReactor : public FRunnable
+{
+public:
+    /** Adopt an accepted socket. Return nullptr to reject (the reactor closes it). */
+    DECLARE_DELEGATE_RetVal_OneParam(TSharedPtr<IReactorConnection>, FOnAccepted,
+        FSocket* /* ClientSocket */);
+
+    FSocketReactor();
+    virtual ~FSocketReactor();
+
+    /** Spawn the network thread and the worker pool */
+    bool Start(int32 NumWorkers);
+
+    /** Stop the network thread, close every socket and drain the worker pool */
+    void Shutdown();
+
+    /**
+     * Open a listening socket on the given endpoint. Accepted sockets are
+     * passed to Handler on the reactor thread. Returns a listener id, or
+     * INDEX_NONE on failure.
+     */
+    int32 AddListener(const FIPv4Endpoint& Endpoint, const FString& Description, FOnAccepted Handler);
+
+    /**
+     * Open a Unix domain socket listener at Path with the given file mode.
+     * Only available on Unix platforms; returns INDEX_NONE elsewhere.
+     */
+    int32 AddLocalListener(const FString& Path, int32 FileMode, const FString& Description, FOnAccepted Handler);
+
+    /** Close a listener and every connection it accepted. Blocks until done. */
+    void RemoveListener(int32 ListenerId);
+
+    /** Sockets owned at once across all listeners; extra clients are closed on accept */
+    void SetMaxConnections(int32 InMaxConnections) { MaxConnections = InMaxConnections; }
+
+    /** Snapshot of the connection counters */
+    FReactorStats GetStats() const;
+
+    /** Run a task on the worker pool; higher priorities are picked up first */
+    void QueueWork(TUniqueFunction<void()> Work, EQueuedWorkPriority Priority = EQueuedWorkPriority::Normal);
+
+    /**
+     * Run a task on the worker pool once DelaySeconds have passed (any thread).
+     * The reactor thread keeps the time; work still waiting at Shutdown is dropped.
+     */
+    void QueueWorkAfter(double DelaySeconds, TUniqueFunction<void()> Work,
+        EQueuedWorkPriority Priority = EQueuedWorkPriority::Normal);
+
+    /** Wake the network thread early (e.g. a worker queued a response) */
+    void Wake();
+
+    /** Non-blocking read of everything currently available, appended to Buffer */
+    static ESocketIoResult RecvAvailable(FSocket* Socket, TArray<uint8>& Buffer, int32 MaxBytes);
+
+    /** Non-blocking write; OutBytesSent holds how much of Data was accepted */
+    static ESocketIoResult SendSome(FSocket* Socket, const uint8* Data, int32 Count, int32& OutBytesSent);
+
+    /** Close and destroy a socket through the platform subsystem */
+    static void DestroySocket(FSocket* Socket);
+
+    // FRunnable
+    virtual uint32 Run() override;
+    virtual void Stop() override;
+
+private:
+    struct FListener
+    {
+        int32 Id = INDEX_NONE;
+        FSocket* Socket = nullptr;
+        FString Description;
+        FOnAccepted Handler;
+    };
+
+    struct FDelayedWork
+    {
+        double Due = 0.0;
+        TUniqueFunction<void()> Work;
+        EQueuedWorkPriority Priority = EQueuedWorkPriority::Normal;
+    };
+
+    struct FConnectionEntry
+    {
+        TSharedPtr<IReactorConnection> Connection;
+        int32 ListenerId = INDEX_NONE;
+        /** Earliest deadline filed in the wheel for this connection, or 0 */
+        double ArmedDeadline = 0.0;
+    };
+
+    /** Adopt an already listening, non-blocking socket */
+    int32 AdoptListener(FSocket* ListenSocket, const FString& Description, FOnAccepted Handler);
+
+    /**
+     * Run a mutation on the reactor thread (or inline when not running) and
+     * wait for it. Returns false without running Op once the reactor is
+     * stopping; Shutdown closes every socket anyway.
+     */
+    bool RunOnReactorThread(TFunction<void()> Op);
+
+    /** Execute mutations posted from other threads */
+    void DrainPendingOps();
+
+    /** Accept all pending connections. Returns true if anything was accepted. */
+    bool AcceptPending();
+
+    /** Service every connection. Returns true if any made progress. */
+    bool ServiceConnections(double Now);
+
+    /** File the connection's deadline if it is earlier than the one already armed */
+    void ArmDeadline(FConnectionEntry& Entry);
+
+    /** Hand delayed work that is due to the worker pool; returns the next due time, or 0 */
+    double QueueDueWork(double Now);
+
+    /** Fire deadlines that have passed. Returns true if any connection was dropped. */
+    bool ExpireDeadlines(double Now);
+
+    /** Block until a listener or connection is ready, a Wake, the next tick, or NextDue (if set) */
+    void WaitForReadiness(double NextDue);
+
+    /** Apply a Close or Upgrade result to the connection at Index */
+    void RetireConnection(int32 Index, EServiceResult Result);
+
+    /** Drop every connection and listener */
+    void CloseAll();
+
+    TArray<FListener> Listeners;
+    TArray<FConnectionEntry> Connections;
+    int32 NextListenerId = 1;
+    FTimerWheel Deadlines;
+    int32 MaxConnections = 0;
+
+    TAtomic<int32> NumConnections { 0 };
+    TAtomic<int64> NumAccepted { 0 };
+    TAtomic<int64> NumRefused { 0 };
+    TAtomic<int64> NumTimedOut { 0 };
+
+    TQueue<TFunction<void()>, EQueueMode::Mpsc> PendingOps;
+
+    /** Delayed work posted from any thread, then held by the reactor thread until due */
+    TQueue<FDelayedWork, EQueueMode::Mpsc> IncomingDelayedWork;
+    TArray<FDelayedWork> DelayedWork;
+    /** Orders posting an op against Shutdown's final drain, so none is left waiting */
+    FCriticalSection PendingOpsMutex;
+
+    FRunnableThread* Thread = nullptr;
+    FQueuedThreadPool* WorkerPool = nullptr;
+    FEvent* WakeEvent = nullptr;
+    FSocketPoller Poller;
+    TAtomic<bool> bStopping { false };
+};
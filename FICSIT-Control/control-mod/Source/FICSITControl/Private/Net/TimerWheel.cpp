@@ -0,0 +1,59 @@
+#include "TimerWheel.h"
+#include "SocketReactor.h"
+
+FTimerWheel::FTimerWheel(double InTickSeconds, int32 InNumSlots)
+    : TickSeconds(InTickSeconds)
+{
+    Slots.SetNum(FMath::Max(1, InNumSlots));
+}
+
+void FTimerWheel::Schedule(double Deadline, const TSharedPtr<IReactorConnection>& Connection)
+{
+    // File in the tick after the deadline's, so the slot is only reached once
+    // the deadline has passed; a slot visited early would skip the entry for a
+    // full revolution. Never behind the cursor, for the same reason.
+    const int64 Tick = FMath::Max(ToTick(Deadline) + 1, CurrentTick + 1);
+    Slots[Tick % Slots.Num()].Add({ Deadline, Connection });
+}
+
+void FTimerWheel::Advance(double Now, TArray<TSharedPtr<IReactorConnection>>& OutExpired)
+{
+    const int64 NowTick = ToTick(Now);
+    if (CurrentTick < 0)
+    {
+        CurrentTick = NowTick - 1;
+    }
+
+    // After a long stall every slot is due at most once
+    const int64 FirstTick = FMath::Max(CurrentTick + 1, NowTick - Slots.Num() + 1);
+
+    for (int64 Tick = FirstTick; Tick <= NowTick; ++Tick)
+    {
+        TArray<FEntry>& Slot = Slots[Tick % Slots.Num()];
+        for (int32 i = Slot.Num() - 1; i >= 0; --i)
+        {
+            // Only entries a revolution or more away are left for later
+            if (Slot[i].Deadline > Now)
+            {
+                continue;
+            }
+
+            if (TSharedPtr<IReactorConnection> Connection = Slot[i].Connection.Pin())
+            {
+                OutExpired.Add(MoveTemp(Connection));
+            }
+            Slot.RemoveAtSwap(i, 1, false);
+        }
+    }
+
+    CurrentTick = NowTick;
+}
+
+void FTimerWheel::Reset()
+{
+    for (TArray<FEntry>& Slot : Slots)
+    {
+        Slot.Empty();
+    }
+    CurrentTick = -1;
+}
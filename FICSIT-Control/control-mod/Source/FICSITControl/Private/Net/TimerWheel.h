@@ -0,0 +1,44 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IReactorConnection;
+
+/**
+ * Hashed timing wheel for connection deadlines, driven by the reactor thread.
+ * Each slot covers one tick, and an entry fires within one tick after its
+ * deadline; one further out than a revolution stays in its slot and is
+ * skipped until its round comes up. Entries are never cancelled: a
+ * connection whose deadline moved is simply re-checked when the stale entry
+ * fires. Scheduling and expiry are O(1) per entry, so the cost
+ * of a sweep does not grow with the number of idle connections.
+ */
+class FTimerWheel
+{
+public:
+    FTimerWheel(double InTickSeconds = 0.1, int32 InNumSlots = 512);
+
+    /** Fire Connection once Deadline (absolute FPlatformTime seconds) has passed */
+    void Schedule(double Deadline, const TSharedPtr<IReactorConnection>& Connection);
+
+    /** Collect every entry due by Now, in no particular order */
+    void Advance(double Now, TArray<TSharedPtr<IReactorConnection>>& OutExpired);
+
+    /** Drop all entries */
+    void Reset();
+
+private:
+    struct FEntry
+    {
+        double Deadline;
+        TWeakPtr<IReactorConnection> Connection;
+    };
+
+    int64 ToTick(double Time) const { return static_cast<int64>(Time / TickSeconds); }
+
+    double TickSeconds;
+    TArray<TArray<FEntry>> Slots;
+
+    /** Last tick whose slot has been processed; -1 before the first Advance */
+    int64 CurrentTick = -1;
+};
@@ -0,0 +1,336 @@
+#include "UnixDomainSocket.h"
+
+#if PLATFORM_UNIX
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+DEFINE_LOG_CATEGORY_STATIC(LogUnixDomainSocket, Log, All);
+
+const FName FUnixDomainSocket::ProtocolName(TEXT("Unix"));
+
+FSocket* FUnixDomainSocket::CreateListener(const FString& Path, int32 FileMode, const FString& Description)
+{
+    const FTCHARToUTF8 PathUtf8(*Path);
+
+    sockaddr_un Addr = {};
+    Addr.sun_family = AF_UNIX;
+    if (PathUtf8.Length() <= 0 || PathUtf8.Length() >= static_cast<int32>(sizeof(Addr.sun_path)))
+    {
+        UE_LOG(LogUnixDomainSocket, Error, TEXT("Socket path '%s' is empty or too long"), *Path);
+        return nullptr;
+    }
+    FMemory::Memcpy(Addr.sun_path, PathUtf8.Get(), PathUtf8.Length());
+
+    // Replace a socket file left behind by a previous run, but never anything else
+    struct stat Existing;
+    if (lstat(Addr.sun_path, &Existing) == 0)
+    {
+        if (!S_ISSOCK(Existing.st_mode))
+        {
+            UE_LOG(LogUnixDomainSocket, Error, TEXT("'%s' exists and is not a socket"), *Path);
+            return nullptr;
+        }
+        unlink(Addr.sun_path);
+    }
+
+    const int32 Fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (Fd < 0)
+    {
+        UE_LOG(LogUnixDomainSocket, Error, TEXT("socket() failed: errno %d"), errno);
+        return nullptr;
+    }
+
+    // Create the file with no access, then open it up to the configured mode,
+    // so nobody can connect in between
+    const mode_t OldMask = umask(0777);
+    const int32 BindResult = bind(Fd, reinterpret_cast<const sockaddr*>(&Addr), sizeof(Addr));
+    umask(OldMask);
+
+    if (BindResult != 0 || chmod(Addr.sun_path, static_cast<mode_t>(FileMode & 0777)) != 0 || listen(Fd, 128) != 0)
+    {
+        UE_LOG(LogUnixDomainSocket, Error, TEXT("Failed to listen on '%s': errno %d"), *Path, errno);
+        if (BindResult == 0)
+        {
+            unlink(Addr.sun_path);
+        }
+        close(Fd);
+        return nullptr;
+    }
+
+    FUnixDomainSocket* Socket = new FUnixDomainSocket(Fd, Description, Path);
+    Socket->SetNonBlocking(true);
+    return Socket;
+}
+
+FUnixDomainSocket::FUnixDomainSocket(int32 InDescriptor, const FString& InDescription, const FString& InListenPath)
+    : FSocket(SOCKTYPE_Streaming, InDescription, ProtocolName)
+    , Descriptor(InDescriptor)
+    , ListenPath(InListenPath)
+{
+}
+
+FUnixDomainSocket::~FUnixDomainSocket()
+{
+    Close();
+}
+
+bool FUnixDomainSocket::Shutdown(ESocketShutdownMode Mode)
+{
+    const int32 How = Mode == ESocketShutdownMode::Read ? SHUT_RD
+        : Mode == ESocketShutdownMode::Write ? SHUT_WR : SHUT_RDWR;
+    return Descriptor >= 0 && shutdown(Descriptor, How) == 0;
+}
+
+bool FUnixDomainSocket::Close()
+{
+    if (Descriptor < 0) return false;
+
+    close(Descriptor);
+    Descriptor = -1;
+
+    if (!ListenPath.IsEmpty())
+    {
+        unlink(TCHAR_TO_UTF8(*ListenPath));
+        ListenPath.Reset();
+    }
+    return true;
+}
+
+bool FUnixDomainSocket::Bind(const FInternetAddr& Addr)
+{
+    // Path sockets are bound by CreateListener
+    return false;
+}
+
+bool FUnixDomainSocket::Connect(const FInternetAddr& Addr)
+{
+    return false;
+}
+
+bool FUnixDomainSocket::Listen(int32 MaxBacklog)
+{
+    return Descriptor >= 0 && listen(Descriptor, MaxBacklog) == 0;
+}
+
+bool FUnixDomainSocket::WaitForPendingConnection(bool& bHasPendingConnection, const FTimespan& WaitTime)
+{
+    const int32 Events = PollFor(POLLIN, static_cast<int32>(WaitTime.GetTotalMilliseconds()));
+    bHasPendingConnection = Events > 0 && (Events & POLLIN) != 0;
+    return Events >= 0;
+}
+
+bool FUnixDomainSocket::HasPendingConnection(bool& bHasPendingConnection)
+{
+    return WaitForPendingConnection(bHasPendingConnection, FTimespan::Zero());
+}
+
+bool FUnixDomainSocket::HasPendingData(uint32& PendingDataSize)
+{
+    int Available = 0;
+    if (Descriptor < 0 || ioctl(Descriptor, FIONREAD, &Available) != 0)
+    {
+        PendingDataSize = 0;
+        return false;
+    }
+    PendingDataSize = static_cast<uint32>(FMath::Max(Available, 0));
+    return PendingDataSize > 0;
+}
+
+FSocket* FUnixDomainSocket::Accept(const FString& InSocketDescription)
+{
+    if (Descriptor < 0) return nullptr;
+
+    const int32 ClientFd = accept4(Descriptor, nullptr, nullptr, SOCK_CLOEXEC);
+    if (ClientFd < 0)
+    {
+        return nullptr;
+    }
+    return new FUnixDomainSocket(ClientFd, InSocketDescription);
+}
+
+FSocket* FUnixDomainSocket::Accept(FInternetAddr& OutAddr, const FString& InSocketDescription)
+{
+    // Peers have no IP address to report
+    return Accept(InSocketDescription);
+}
+
+bool FUnixDomainSocket::SendTo(const uint8* Data, int32 Count, int32& BytesSent, const FInternetAddr& Destination)
+{
+    return Send(Data, Count, BytesSent);
+}
+
+bool FUnixDomainSocket::Send(const uint8* Data, int32 Count, int32& BytesSent)
+{
+    // MSG_NOSIGNAL: a vanished peer is an error result, not SIGPIPE
+    const ssize_t Result = send(Descriptor, Data, Count, MSG_NOSIGNAL);
+    BytesSent = Result >= 0 ? static_cast<int32>(Result) : -1;
+    return Result >= 0;
+}
+
+bool FUnixDomainSocket::RecvFrom(uint8* Data, int32 BufferSize, int32& BytesRead, FInternetAddr& Source,
+    ESocketReceiveFlags::Type Flags)
+{
+    return Recv(Data, BufferSize, BytesRead, Flags);
+}
+
+bool FUnixDomainSocket::Recv(uint8* Data, int32 BufferSize, int32& BytesRead, ESocketReceiveFlags::Type Flags)
+{
+    int32 RecvFlags = 0;
+    if (Flags & ESocketReceiveFlags::Peek) RecvFlags |= MSG_PEEK;
+    if (Flags & ESocketReceiveFlags::WaitAll) RecvFlags |= MSG_WAITALL;
+
+    const ssize_t Result = recv(Descriptor, Data, BufferSize, RecvFlags);
+    if (Result >= 0)
+    {
+        // Zero bytes is an orderly shutdown on a stream socket
+        BytesRead = static_cast<int32>(Result);
+        return Result > 0;
+    }
+
+    BytesRead = 0;
+    return errno == EAGAIN || errno == EWOULDBLOCK;
+}
+
+bool FUnixDomainSocket::Wait(ESocketWaitConditions::Type Condition, FTimespan WaitTime)
+{
+    int16 Events = 0;
+    if (Condition == ESocketWaitConditions::WaitForRead || Condition == ESocketWaitConditions::WaitForReadOrWrite)
+    {
+        Events |= POLLIN;
+    }
+    if (Condition == ESocketWaitConditions::WaitForWrite || Condition == ESocketWaitConditions::WaitForReadOrWrite)
+    {
+        Events |= POLLOUT;
+    }
+    return PollFor(Events, static_cast<int32>(WaitTime.GetTotalMilliseconds())) > 0;
+}
+
+ESocketConnectionState FUnixDomainSocket::GetConnectionState()
+{
+    if (Descriptor < 0) return SCS_NotConnected;
+
+    const int32 Events = PollFor(0, 0);
+    return Events < 0 || (Events & (POLLERR | POLLHUP | POLLNVAL)) != 0 ? SCS_ConnectionError : SCS_Connected;
+}
+
+void FUnixDomainSocket::GetAddress(FInternetAddr& OutAddr)
+{
+}
+
+bool FUnixDomainSocket::GetPeerAddress(FInternetAddr& OutAddr)
+{
+    return false;
+}
+
+bool FUnixDomainSocket::SetNonBlocking(bool bIsNonBlocking)
+{
+    const int32 Flags = fcntl(Descriptor, F_GETFL, 0);
+    if (Flags < 0) return false;
+    return fcntl(Descriptor, F_SETFL, bIsNonBlocking ? (Flags | O_NONBLOCK) : (Flags & ~O_NONBLOCK)) == 0;
+}
+
+bool FUnixDomainSocket::SetBroadcast(bool bAllowBroadcast)
+{
+    return false;
+}
+
+bool FUnixDomainSocket::SetNoDelay(bool bIsNoDelay)
+{
+    // No Nagle on local sockets; nothing to turn off
+    return true;
+}
+
+bool FUnixDomainSocket::JoinMulticastGroup(const FInternetAddr& GroupAddress)
+{
+    return false;
+}
+
+bool FUnixDomainSocket::JoinMulticastGroup(const FInternetAddr& GroupAddress, const FInternetAddr& InterfaceAddress)
+{
+    return false;
+}
+
+bool FUnixDomainSocket::LeaveMulticastGroup(const FInternetAddr& GroupAddress)
+{
+    return false;
+}
+
+bool FUnixDomainSocket::LeaveMulticastGroup(const FInternetAddr& GroupAddress, const FInternetAddr& InterfaceAddress)
+{
+    return false;
+}
+
+bool FUnixDomainSocket::SetMulticastLoopback(bool bLoopback)
+{
+    return false;
+}
+
+bool FUnixDomainSocket::SetMulticastTtl(uint8 TimeToLive)
+{
+    return false;
+}
+
+bool FUnixDomainSocket::SetMulticastInterface(const FInternetAddr& InterfaceAddress)
+{
+    return false;
+}
+
+bool FUnixDomainSocket::SetReuseAddr(bool bAllowReuse)
+{
+    return false;
+}
+
+bool FUnixDomainSocket::SetLinger(bool bShouldLinger, int32 Timeout)
+{
+    linger Linger;
+    Linger.l_onoff = bShouldLinger ? 1 : 0;
+    Linger.l_linger = Timeout;
+    return setsockopt(Descriptor, SOL_SOCKET, SO_LINGER, &Linger, sizeof(Linger)) == 0;
+}
+
+bool FUnixDomainSocket::SetRecvErr(bool bUseErrorQueue)
+{
+    return false;
+}
+
+bool FUnixDomainSocket::SetSendBufferSize(int32 Size, int32& NewSize)
+{
+    socklen_t Len = sizeof(NewSize);
+    setsockopt(Descriptor, SOL_SOCKET, SO_SNDBUF, &Size, sizeof(Size));
+    return getsockopt(Descriptor, SOL_SOCKET, SO_SNDBUF, &NewSize, &Len) == 0;
+}
+
+bool FUnixDomainSocket::SetReceiveBufferSize(int32 Size, int32& NewSize)
+{
+    socklen_t Len = sizeof(NewSize);
+    setsockopt(Descriptor, SOL_SOCKET, SO_RCVBUF, &Size, sizeof(Size));
+    return getsockopt(Descriptor, SOL_SOCKET, SO_RCVBUF, &NewSize, &Len) == 0;
+}
+
+int32 FUnixDomainSocket::GetPortNo()
+{
+    return 0;
+}
+
+int32 FUnixDomainSocket::PollFor(int16 Events, int32 TimeoutMs) const
+{
+    if (Descriptor < 0) return -1;
+
+    pollfd Poll;
+    Poll.fd = Descriptor;
+    Poll.events = Events;
+    Poll.revents = 0;
+
+    const int32 Result = poll(&Poll, 1, FMath::Max(TimeoutMs, 0));
+    if (Result < 0) return -1;
+    return Result == 0 ? 0 : Poll.revents;
+}
+
+#endif // PLATFORM_UNIX
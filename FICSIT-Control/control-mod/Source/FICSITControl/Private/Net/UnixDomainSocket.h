@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Sockets.h"
+
+#if PLATFORM_UNIX
+
+/**
+ * Stream socket on an AF_UNIX path, for clients on the same host.
+ * The engine's socket subsystem only speaks IP, so this wraps a POSIX
+ * descriptor behind FSocket and implements what the reactor uses:
+ * listen/accept, non-blocking send and receive, and close. Recv and Send
+ * follow the BSD subsystem's conventions (would-block reads succeed with
+ * zero bytes, errors are visible through GetLastErrorCode).
+ */
+class FUnixDomainSocket : public FSocket
+{
+public:
+    /** Protocol name reported by GetProtocol, used to route destruction */
+    static const FName ProtocolName;
+
+    /**
+     * Bind and listen on Path with the given file mode (e.g. 0660).
+     * A stale socket file is replaced; any other file at Path is an error.
+     * Returns nullptr on failure. The file is removed when the socket closes.
+     */
+    static FSocket* CreateListener(const FString& Path, int32 FileMode, const FString& Description);
+
+    FUnixDomainSocket(int32 InDescriptor, const FString& InDescription, const FString& InListenPath = FString());
+    virtual ~FUnixDomainSocket();
+
+    /** The POSIX descriptor, for readiness waits over many sockets */
+    int32 GetDescriptor() const { return Descriptor; }
+
+    // FSocket
+    virtual bool Shutdown(ESocketShutdownMode Mode) override;
+    virtual bool Close() override;
+    virtual bool Bind(const FInternetAddr& Addr) override;
+    virtual bool Connect(const FInternetAddr& Addr) override;
+    virtual bool Listen(int32 MaxBacklog) override;
+    virtual bool WaitForPendingConnection(bool& bHasPendingConnection, const FTimespan& WaitTime) override;
+    virtual bool HasPendingConnection(bool& bHasPendingConnection) override;
+    virtual bool HasPendingData(uint32& PendingDataSize) override;
+    virtual FSocket* Accept(const FString& InSocketDescription) override;
+    virtual FSocket* Accept(FInternetAddr& OutAddr, const FString& InSocketDescription) override;
+    virtual bool SendTo(const uint8* Data, int32 Count, int32& BytesSent, const FInternetAddr& Destination) override;
+    virtual bool Send(const uint8* Data, int32 Count, int32& BytesSent) override;
+    virtual bool RecvFrom(uint8* Data, int32 BufferSize, int32& BytesRead, FInternetAddr& Source,
+        ESocketReceiveFlags::Type Flags = ESocketReceiveFlags::None) override;
+    virtual bool Recv(uint8* Data, int32 BufferSize, int32& BytesRead,
+        ESocketReceiveFlags::Type Flags = ESocketReceiveFlags::None) override;
+    virtual bool Wait(ESocketWaitConditions::Type Condition, FTimespan WaitTime) override;
+    virtual ESocketConnectionState GetConnectionState() override;
+    virtual void GetAddress(FInternetAddr& OutAddr) override;
+    virtual bool GetPeerAddress(FInternetAddr& OutAddr) override;
+    virtual bool SetNonBlocking(bool bIsNonBlocking = true) override;
+    virtual bool SetBroadcast(bool bAllowBroadcast = true) override;
+    virtual bool SetNoDelay(bool bIsNoDelay = true) override;
+    virtual bool JoinMulticastGroup(const FInternetAddr& GroupAddress) override;
+    virtual bool JoinMulticastGroup(const FInternetAddr& GroupAddress, const FInternetAddr& InterfaceAddress) override;
+    virtual bool LeaveMulticastGroup(const FInternetAddr& GroupAddress) override;
+    virtual bool LeaveMulticastGroup(const FInternetAddr& GroupAddress, const FInternetAddr& InterfaceAddress) override;
+    virtual bool SetMulticastLoopback(bool bLoopback) override;
+    virtual bool SetMulticastTtl(uint8 TimeToLive) override;
+    virtual bool SetMulticastInterface(const FInternetAddr& InterfaceAddress) override;
+    virtual bool SetReuseAddr(bool bAllowReuse = true) override;
+    virtual bool SetLinger(bool bShouldLinger = true, int32 Timeout = 0) override;
+    virtual bool SetRecvErr(bool bUseErrorQueue = true) override;
+    virtual bool SetSendBufferSize(int32 Size, int32& NewSize) override;
+    virtual bool SetReceiveBufferSize(int32 Size, int32& NewSize) override;
+    virtual int32 GetPortNo() override;
+
+private:
+    /** Poll the descriptor; returns the revents, or -1 on error */
+    int32 PollFor(int16 Events, int32 TimeoutMs) const;
+
+    int32 Descriptor = -1;
+
+    /** Set on listeners: the socket file to unlink on close */
+    FString ListenPath;
+};
+
+#endif // PLATFORM_UNIX
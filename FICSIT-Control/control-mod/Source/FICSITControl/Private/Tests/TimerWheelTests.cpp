@@ -0,0 +1,81 @@
+#include "Misc/AutomationTest.h"
+#include "Net/SocketReactor.h"
+#include "Net/TimerWheel.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** A connection that only exists to be scheduled */
+class FIdleTestConnection : public IReactorConnection
+{
+public:
+    virtual EServiceResult Service(double Now) override { return EServiceResult::Idle; }
+    virtual void OnClosed() override {}
+};
+
+/** Advance the wheel in small steps from Start and return when Connection first fired (-1 if never) */
+static double FirstFiring(FTimerWheel& Wheel, const TSharedPtr<IReactorConnection>& Connection,
+    double Start, double End, double Step)
+{
+    TArray<TSharedPtr<IReactorConnection>> Expired;
+    for (int32 i = 0; Start + i * Step <= End; ++i)
+    {
+        const double Now = Start + i * Step;
+        Expired.Reset();
+        Wheel.Advance(Now, Expired);
+        if (Expired.Contains(Connection))
+        {
+            return Now;
+        }
+    }
+    return -1.0;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTimerWheelFiresOnTimeTest, "FICSITControl.Net.TimerWheel.FiresWithinOneTick",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTimerWheelFiresOnTimeTest::RunTest(const FString& Parameters)
+{
+    constexpr double Tick = 0.1;
+    constexpr double Step = 0.01;
+    constexpr double Start = 1000.0;
+
+    // Firing is observed at Step granularity; allow for that and rounding
+    constexpr double Slack = Step + 1e-6;
+
+    // Short deadlines that fall mid-tick, on a tick boundary, and past one revolution (51.2 s)
+    const double Delays[] = { 0.05, 5.05, 5.0, 60.03 };
+    for (const double Delay : Delays)
+    {
+        FTimerWheel Wheel(Tick, 512);
+        TArray<TSharedPtr<IReactorConnection>> Expired;
+        Wheel.Advance(Start, Expired);
+
+        TSharedPtr<IReactorConnection> Connection = MakeShared<FIdleTestConnection>();
+        const double Deadline = Start + Delay;
+        Wheel.Schedule(Deadline, Connection);
+
+        const double Fired = FirstFiring(Wheel, Connection, Start, Deadline + 60.0, Step);
+        TestTrue(FString::Printf(TEXT("Deadline +%.2fs fired"), Delay), Fired >= 0.0);
+        TestTrue(FString::Printf(TEXT("Deadline +%.2fs not early (fired at +%.2fs)"), Delay, Fired - Start),
+            Fired >= Deadline);
+        TestTrue(FString::Printf(TEXT("Deadline +%.2fs within one tick (fired at +%.2fs)"), Delay, Fired - Start),
+            Fired <= Deadline + Tick + Slack);
+    }
+
+    // A deadline already past when scheduled fires on the next advance past the cursor
+    {
+        FTimerWheel Wheel(Tick, 512);
+        TArray<TSharedPtr<IReactorConnection>> Expired;
+        Wheel.Advance(Start, Expired);
+
+        TSharedPtr<IReactorConnection> Connection = MakeShared<FIdleTestConnection>();
+        Wheel.Schedule(Start - 1.0, Connection);
+
+        const double Fired = FirstFiring(Wheel, Connection, Start, Start + 1.0, Step);
+        TestTrue(TEXT("Past deadline fires within one tick"), Fired >= 0.0 && Fired <= Start + Tick + Slack);
+    }
+
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
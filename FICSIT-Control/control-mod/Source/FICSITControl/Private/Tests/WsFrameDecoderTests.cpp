@@ -0,0 +1,117 @@
+#include "Misc/AutomationTest.h"
+#include "WebSocket/WsFrameDecoder.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWsFrameDecoderUnmaskTest, "FICSITControl.WebSocket.FrameDecoder.Unmask",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FWsFrameDecoderUnmaskTest::RunTest(const FString& Parameters)
+{
+    const uint8 Key[4] = { 0x37, 0xFA, 0x21, 0x3D };
+
+    // Every tail length after the 16-byte and 8-byte passes (1-15), past one
+    // and two whole registers, and from unaligned starting addresses
+    for (int32 Offset = 0; Offset < 4; ++Offset)
+    {
+        for (int32 Len = 0; Len <= 48; ++Len)
+        {
+            TArray<uint8> Buffer;
+            Buffer.SetNumUninitialized(Offset + Len);
+            for (int32 i = 0; i < Buffer.Num(); ++i)
+            {
+                Buffer[i] = static_cast<uint8>(i * 31 + 7);
+            }
+            const TArray<uint8> Original = Buffer;
+
+            FWsFrameDecoder::Unmask(Buffer.GetData() + Offset, Len, Key);
+
+            bool bMatches = true;
+            for (int32 i = 0; i < Buffer.Num(); ++i)
+            {
+                const uint8 Expected = i < Offset
+                    ? Original[i]
+                    : static_cast<uint8>(Original[i] ^ Key[(i - Offset) & 3]);
+                bMatches &= Buffer[i] == Expected;
+            }
+            TestTrue(FString::Printf(TEXT("Unmask of %d bytes at offset %d"), Len, Offset), bMatches);
+
+            // Masking is its own inverse
+            FWsFrameDecoder::Unmask(Buffer.GetData() + Offset, Len, Key);
+            TestTrue(FString::Printf(TEXT("Unmask twice of %d bytes at offset %d"), Len, Offset), Buffer == Original);
+        }
+    }
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWsFrameDecoderUtf8Test, "FICSITControl.WebSocket.FrameDecoder.ValidatesUtf8",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FWsFrameDecoderUtf8Test::RunTest(const FString& Parameters)
+{
+    struct FCase
+    {
+        const TCHAR* Name;
+        TArray<uint8> Bytes;
+        bool bValid;
+    };
+
+    const FCase Cases[] = {
+        { TEXT("empty"),                          {},                               true  },
+        { TEXT("ASCII"),                          { 'a', 'b', 'c' },                true  },
+        { TEXT("U+0080"),                         { 0xC2, 0x80 },                   true  },
+        { TEXT("U+07FF"),                         { 0xDF, 0xBF },                   true  },
+        { TEXT("U+0800"),                         { 0xE0, 0xA0, 0x80 },             true  },
+        { TEXT("U+D7FF"),                         { 0xED, 0x9F, 0xBF },             true  },
+        { TEXT("U+E000"),                         { 0xEE, 0x80, 0x80 },             true  },
+        { TEXT("U+FFFF"),                         { 0xEF, 0xBF, 0xBF },             true  },
+        { TEXT("U+10000"),                        { 0xF0, 0x90, 0x80, 0x80 },       true  },
+        { TEXT("U+10FFFF"),                       { 0xF4, 0x8F, 0xBF, 0xBF },       true  },
+
+        { TEXT("overlong NUL (2 bytes)"),         { 0xC0, 0x80 },                   false },
+        { TEXT("overlong U+007F (2 bytes)"),      { 0xC1, 0xBF },                   false },
+        { TEXT("overlong U+07FF (3 bytes)"),      { 0xE0, 0x9F, 0xBF },             false },
+        { TEXT("overlong U+FFFF (4 bytes)"),      { 0xF0, 0x8F, 0xBF, 0xBF },       false },
+
+        { TEXT("high surrogate U+D800"),          { 0xED, 0xA0, 0x80 },             false },
+        { TEXT("low surrogate U+DFFF"),           { 0xED, 0xBF, 0xBF },             false },
+        { TEXT("surrogate pair as CESU-8"),       { 0xED, 0xA0, 0xBD, 0xED, 0xB2, 0xA9 }, false },
+
+        { TEXT("U+110000"),                       { 0xF4, 0x90, 0x80, 0x80 },       false },
+        { TEXT("lead byte F5"),                   { 0xF5, 0x80, 0x80, 0x80 },       false },
+        { TEXT("5-byte lead F8"),                 { 0xF8, 0x88, 0x80, 0x80, 0x80 }, false },
+        { TEXT("lead byte FF"),                   { 0xFF },                         false },
+
+        { TEXT("truncated 2-byte"),               { 0xC2 },                         false },
+        { TEXT("truncated 3-byte after 1"),       { 0xE2, 0x82 },                   false },
+        { TEXT("truncated 4-byte after 2"),       { 0xF0, 0x9F, 0x98 },             false },
+        { TEXT("continuation replaced by ASCII"), { 0xE2, 'a', 0xAC },              false },
+        { TEXT("lone continuation byte"),         { 0x80 },                         false },
+    };
+
+    for (const FCase& Case : Cases)
+    {
+        // Behind ASCII runs of every length up to two words, so the sequence
+        // is met both by the word-at-a-time skip and by the byte loop, and
+        // with ASCII after it as well as at the very end of the buffer
+        for (int32 Prefix = 0; Prefix <= 16; ++Prefix)
+        {
+            for (const int32 Suffix : { 0, 9 })
+            {
+                TArray<uint8> Bytes;
+                Bytes.Init('x', Prefix);
+                Bytes.Append(Case.Bytes);
+                Bytes.AddUninitialized(Suffix);
+                FMemory::Memset(Bytes.GetData() + Bytes.Num() - Suffix, 'y', Suffix);
+
+                TestEqual(FString::Printf(TEXT("%s after %d and before %d ASCII bytes"), Case.Name, Prefix, Suffix),
+                    FWsFrameDecoder::IsValidUtf8(Bytes.GetData(), Bytes.Num()), Case.bValid);
+            }
+        }
+    }
+
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
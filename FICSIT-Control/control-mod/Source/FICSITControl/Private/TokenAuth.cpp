@@ -1,4 +1,14 @@
 #include "TokenAuth.h"
+#include "Misc/SecureHash.h"
 
-// All logic is inline in the header.
-// This file exists for UBT compilation unit requirements.
+FString FTokenAuth::Fingerprint(const FString& InToken)
+{
+    if (InToken.IsEmpty()) return FString();
+
+    const FTCHARToUTF8 Utf8(*InToken);
+    uint8 Hash[FSHA1::DigestSize];
+    FSHA1::HashBuffer(Utf8.Get(), Utf8.Length(), Hash);
+
+    // 64 bits tell the handful of tokens in use apart without being reversible
+    return BytesToHex(Hash, 8).ToLower();
+}
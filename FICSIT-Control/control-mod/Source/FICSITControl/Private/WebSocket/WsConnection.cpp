@@ -1,127 +1,227 @@
 #include "WsConnection.h"
-#include "SocketSubsystem.h"
+#include "WsServer.h"
+#include "Events/ControlEventCbor.h"
+#include "Auth/TokenAuth.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogWsConnection, Log, All);
 
-FWsConnection::FWsConnection(FSocket* InSocket, const FString& InToken)
+// Largest message a client may send, reassembled and inflated
+static constexpr int32 MaxMessageBytes = 1024 * 1024;
+
+// Bounds on what one client may ask the subscription index to hold
+static constexpr int32 MaxSubscriptionsPerConnection = 32;
+static constexpr int32 MaxFilterValues = 256;
+
+// Correlation IDs are echoed in every event about the command
+static constexpr int32 MaxRequestIdLength = 128;
+
+// Identifies the connection a command was submitted on; never reused
+static TAtomic<uint64> NextStreamId { 1 };
+
+FWsConnection::FWsConnection(FSocket* InSocket, const FWsSessionOptions& InSession, FWsServer& InServer)
     : Socket(InSocket)
-    , Token(InToken)
+    , Issuer(FTokenAuth::Fingerprint(InSession.Token))
+    , Encoding(InSession.Encoding)
+    , Server(InServer)
+    , StreamId(NextStreamId++)
+    , Decoder(MaxMessageBytes)
     , bOpen(true)
 {
+    if (InSession.Deflate.bEnabled)
+    {
+        Deflate = MakeUnique<FWsDeflate>(InSession.Deflate);
+        Decoder.SetAllowCompressed(true);
+    }
 }
 
 FWsConnection::~FWsConnection()
 {
-    Close();
+    Close(1001);
 }
 
-void FWsConnection::Send(const FString& Message)
+EServiceResult FWsConnection::Service(double Now)
 {
-    if (!IsOpen()) return;
+    if (!Socket) return EServiceResult::Close;
 
-    TArray<uint8> Frame = EncodeTextFrame(Message);
-    SendRaw(Frame);
-}
+    // Evict a reader that fell past the high-water mark
+    if (bOverflowed)
+    {
+        Server.OnSlowClientEvicted();
+        Close(1013, TEXT("Client too slow"));
+        return EServiceResult::Close;
+    }
 
-void FWsConnection::Close(uint16 Code, const FString& Reason)
-{
-    if (!bOpen) return;
-    bOpen = false;
+    bool bProgress = false;
+    if (!FlushSendQueue(bProgress))
+    {
+        return EServiceResult::Close;
+    }
 
-    if (Socket)
+    const ESocketIoResult Received = Decoder.Receive(Socket);
+    if (Received == ESocketIoResult::Closed)
     {
-        // Send close frame
-        TArray<uint8> CloseFrame;
-        CloseFrame.Add(0x88); // FIN + Close opcode
-        CloseFrame.Add(0x02); // Payload length = 2 (just the code)
-        CloseFrame.Add((Code >> 8) & 0xFF);
-        CloseFrame.Add(Code & 0xFF);
-        SendRaw(CloseFrame);
+        UE_LOG(LogWsConnection, Log, TEXT("Connection closed by client"));
+        return EServiceResult::Close;
+    }
 
-        Socket->Close();
-        ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
-        Socket = nullptr;
+    if (Received == ESocketIoResult::Ok)
+    {
+        bProgress = true;
+        ProcessReceived();
+
+        // Pongs and the reply to a close frame go out on this pass
+        if (!FlushSendQueue(bProgress) || !IsOpen())
+        {
+            Close();
+            return EServiceResult::Close;
+        }
     }
+
+    return bProgress ? EServiceResult::Busy : EServiceResult::Idle;
 }
 
-bool FWsConnection::Tick()
+double FWsConnection::GetDeadline() const
 {
-    if (!IsOpen()) return false;
+    return Socket && PingInterval > 0.0f ? NextPingTime : 0.0;
+}
 
-    // Check for incoming data
-    uint32 PendingSize = 0;
-    if (!Socket->HasPendingData(PendingSize) || PendingSize == 0)
+EServiceResult FWsConnection::OnDeadline(double Now)
+{
+    // A ping still unanswered when the next is due counts as missed
+    if (PingSentTime > 0.0 && ++MissedPongs >= MaxMissedPongs)
     {
-        return true; // No data, still alive
+        UE_LOG(LogWsConnection, Log, TEXT("Client missed %d pongs; dropping dead connection"), MissedPongs.Load());
+        Server.OnDeadPeerDropped();
+        Close(1001, TEXT("Ping timeout"));
+        return EServiceResult::Close;
     }
 
-    TArray<uint8> Buffer;
-    Buffer.SetNumUninitialized(FMath::Min(PendingSize, 65536u));
-    int32 BytesRead = 0;
+    SendPing(Now);
+    NextPingTime = Now + PingInterval;
+    return EServiceResult::Busy;
+}
+
+void FWsConnection::SetHeartbeat(float InInterval, int32 InMaxMissed)
+{
+    PingInterval = FMath::Max(InInterval, 0.0f);
+    MaxMissedPongs = FMath::Max(InMaxMissed, 1);
+    NextPingTime = FPlatformTime::Seconds() + PingInterval;
+}
+
+void FWsConnection::OnClosed()
+{
+    // Reached on shutdown or when the listener goes away: tell the client why
+    Close(1001, TEXT("Server shutting down"));
+    Server.RemoveConnection(this);
+}
+
+void FWsConnection::Send(const FString& Message)
+{
+    if (!IsOpen()) return;
+
+    FTCHARToUTF8 Utf8(*Message);
+    SendFrame(EncodeTextFrame(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length()));
+}
 
-    if (!Socket->Recv(Buffer.GetData(), Buffer.Num(), BytesRead) || BytesRead <= 0)
+void FWsConnection::SendFrame(const FWsFrameRef& Frame)
+{
+    if (!IsOpen() || bOverflowed) return;
+
+    // High-water mark: a reader this far behind is evicted rather than buffered
+    if (QueuedBytes.Load() + Frame->Num() > MaxQueuedBytes)
     {
-        UE_LOG(LogWsConnection, Log, TEXT("Connection closed by client"));
-        bOpen = false;
-        return false;
+        UE_LOG(LogWsConnection, Warning, TEXT("Client fell %lld bytes behind; disconnecting"), QueuedBytes.Load());
+        bOverflowed = true;
+        Server.WakeReactor();
+        return;
     }
 
-    Buffer.SetNum(BytesRead);
+    QueuedBytes += Frame->Num();
+    ++QueuedFrames;
+    SendQueue.Enqueue(Frame);
+
+    // Producers may be on any thread; the reactor may be blocked waiting for sockets
+    Server.WakeReactor();
+}
 
-    // Append to receive buffer
-    ReceiveBuffer.Append(Buffer);
+void FWsConnection::Close(uint16 Code, const FString& Reason)
+{
+    bOpen = false;
 
-    // Try to decode frames from the buffer
-    while (ReceiveBuffer.Num() >= 2)
+    if (Socket)
     {
-        int32 PayloadStart, PayloadLen;
-        bool bMasked;
-        uint8 MaskKey[4];
-
-        int32 Opcode = DecodeFrame(ReceiveBuffer, PayloadStart, PayloadLen, bMasked, MaskKey);
+        // Best-effort close frame behind whatever is still queued
+        TSharedRef<TArray<uint8>> CloseFrame = MakeShared<TArray<uint8>>();
+        CloseFrame->Add(0x88); // FIN + Close opcode
+        CloseFrame->Add(0x02); // Payload length = 2 (just the code)
+        CloseFrame->Add((Code >> 8) & 0xFF);
+        CloseFrame->Add(Code & 0xFF);
+        ++QueuedFrames;
+        QueuedBytes += CloseFrame->Num();
+        SendQueue.Enqueue(CloseFrame);
+
+        bool bProgress = false;
+        FlushSendQueue(bProgress);
+
+        FSocketReactor::DestroySocket(Socket);
+        Socket = nullptr;
+    }
+}
 
-        if (Opcode < 0)
+void FWsConnection::ProcessReceived()
+{
+    // Nothing after a close frame counts
+    FWsDecodedMessage Message;
+    while (IsOpen())
+    {
+        const FWsFrameDecoder::EResult Result = Decoder.Next(Message);
+        if (Result == FWsFrameDecoder::EResult::NeedMore)
         {
-            break; // Need more data or error
+            return;
         }
-
-        int32 FrameLen = PayloadStart + PayloadLen;
-        if (ReceiveBuffer.Num() < FrameLen)
+        if (Result == FWsFrameDecoder::EResult::Error)
         {
-            break; // Need more data
+            UE_LOG(LogWsConnection, Verbose, TEXT("Protocol error: %s"), Decoder.GetError());
+            Close(Decoder.GetCloseCode(), Decoder.GetError());
+            return;
         }
 
-        // Extract and unmask payload
-        TArray<uint8> Payload;
-        Payload.SetNumUninitialized(PayloadLen);
-        FMemory::Memcpy(Payload.GetData(), ReceiveBuffer.GetData() + PayloadStart, PayloadLen);
-
-        if (bMasked)
+        TConstArrayView<uint8> Payload = Message.Payload;
+        if (Message.bCompressed)
         {
-            for (int32 i = 0; i < PayloadLen; ++i)
+            if (!Deflate->Decompress(Payload.GetData(), Payload.Num(), MaxMessageBytes, Inflated))
             {
-                Payload[i] ^= MaskKey[i % 4];
+                Close(1007, TEXT("Invalid compressed message"));
+                return;
             }
+            Payload = Inflated;
         }
 
-        // Remove consumed data
-        ReceiveBuffer.RemoveAt(0, FrameLen);
+        if (Message.Opcode == 0x01 && !FWsFrameDecoder::IsValidUtf8(Payload.GetData(), Payload.Num()))
+        {
+            Close(1007, TEXT("Invalid UTF-8"));
+            return;
+        }
 
-        ProcessFrame(static_cast<uint8>(Opcode), Payload);
+        ProcessFrame(Message.Opcode, Payload);
     }
-
-    return IsOpen();
 }
 
-TArray<uint8> FWsConnection::EncodeTextFrame(const FString& Text)
+FWsFrameRef FWsConnection::EncodeTextFrame(const uint8* Utf8, int32 Len)
 {
-    FTCHARToUTF8 Utf8(*Text);
-    int32 Len = Utf8.Length();
+    // FIN + Text opcode
+    return EncodeFrame(0x81, Utf8, Len);
+}
 
-    TArray<uint8> Frame;
+FWsFrameRef FWsConnection::EncodeFrame(uint8 FirstByte, const uint8* Payload, int32 Len)
+{
+    TSharedRef<TArray<uint8>> FrameRef = MakeShared<TArray<uint8>>();
+    TArray<uint8>& Frame = *FrameRef;
+    Frame.Reserve(Len + 10);
 
-    // FIN + Text opcode
-    Frame.Add(0x81);
+    Frame.Add(FirstByte);
 
     // Payload length (server frames are unmasked)
     if (Len < 126)
@@ -140,60 +240,50 @@ TArray<uint8> FWsConnection::EncodeTextFrame(const FString& Text)
         // 8-byte length (big-endian)
         for (int32 i = 7; i >= 0; --i)
         {
-            Frame.Add((Len >> (i * 8)) & 0xFF);
+            Frame.Add((static_cast<uint64>(Len) >> (i * 8)) & 0xFF);
         }
     }
 
     // Payload
-    Frame.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Len);
+    Frame.Append(Payload, Len);
 
-    return Frame;
+    return FrameRef;
 }
 
-int32 FWsConnection::DecodeFrame(const TArray<uint8>& Data, int32& OutPayloadStart,
-    int32& OutPayloadLen, bool& OutMasked, uint8 OutMaskKey[4])
+TSharedPtr<const TArray<uint8>> FWsConnection::CompressFrame(const TSharedPtr<const TArray<uint8>>& Frame)
 {
-    if (Data.Num() < 2) return -1;
-
-    uint8 Byte0 = Data[0];
-    uint8 Byte1 = Data[1];
-
-    int32 Opcode = Byte0 & 0x0F;
-    OutMasked = (Byte1 & 0x80) != 0;
-    int32 PayloadLen = Byte1 & 0x7F;
-    int32 HeaderLen = 2;
-
-    if (PayloadLen == 126)
+    // Only whole, uncompressed text or binary messages; control frames never are
+    const TArray<uint8>& Data = *Frame;
+    if (Data.Num() < 2 || (Data[0] != 0x81 && Data[0] != 0x82))
     {
-        if (Data.Num() < 4) return -1;
-        PayloadLen = (Data[2] << 8) | Data[3];
-        HeaderLen = 4;
+        return Frame;
     }
-    else if (PayloadLen == 127)
+
+    const uint8 Len7 = Data[1] & 0x7F;
+    const int32 HeaderLen = Len7 == 127 ? 10 : Len7 == 126 ? 4 : 2;
+    const int32 PayloadLen = Data.Num() - HeaderLen;
+    if (PayloadLen < DeflateThreshold)
     {
-        if (Data.Num() < 10) return -1;
-        PayloadLen = 0;
-        for (int32 i = 0; i < 8; ++i)
-        {
-            PayloadLen = (PayloadLen << 8) | Data[2 + i];
-        }
-        HeaderLen = 10;
+        return Frame;
     }
 
-    if (OutMasked)
+    TArray<uint8> Compressed;
+    if (!Deflate->Compress(Data.GetData() + HeaderLen, PayloadLen, Compressed))
     {
-        if (Data.Num() < HeaderLen + 4) return -1;
-        FMemory::Memcpy(OutMaskKey, Data.GetData() + HeaderLen, 4);
-        HeaderLen += 4;
+        // The compressor state is unknown now, but uncompressed messages are always valid
+        UE_LOG(LogWsConnection, Warning, TEXT("Compression failed; sending uncompressed from now on"));
+        DeflateThreshold = MAX_int32;
+        return Frame;
     }
 
-    OutPayloadStart = HeaderLen;
-    OutPayloadLen = PayloadLen;
+    DeflateBytesIn += PayloadLen;
+    DeflateBytesOut += Compressed.Num();
 
-    return Opcode;
+    // FIN + RSV1 + original opcode
+    return EncodeFrame(Data[0] | 0x40, Compressed.GetData(), Compressed.Num());
 }
 
-void FWsConnection::ProcessFrame(uint8 Opcode, const TArray<uint8>& Payload)
+void FWsConnection::ProcessFrame(uint8 Opcode, TConstArrayView<uint8> Payload)
 {
     switch (Opcode)
     {
@@ -207,14 +297,15 @@ void FWsConnection::ProcessFrame(uint8 Opcode, const TArray<uint8>& Payload)
         break;
 
     case 0x0A: // Pong
-        // Ignore
+        HandlePong(Payload);
         break;
 
     case 0x01: // Text
+        HandleTextMessage(Payload);
+        break;
+
     case 0x02: // Binary
-        // We don't expect client-to-server data messages
-        UE_LOG(LogWsConnection, Verbose, TEXT("Received data frame (opcode %d, %d bytes)"),
-            Opcode, Payload.Num());
+        UE_LOG(LogWsConnection, Verbose, TEXT("Ignoring binary frame (%d bytes)"), Payload.Num());
         break;
 
     default:
@@ -223,19 +314,269 @@ void FWsConnection::ProcessFrame(uint8 Opcode, const TArray<uint8>& Payload)
     }
 }
 
-void FWsConnection::SendPong(const TArray<uint8>& Payload)
+/** Read an optional array of strings into Out; false if present but malformed */
+static bool ReadFilterSet(const FJsonObject& Filter, const TCHAR* Field, TSet<FString>& Out)
 {
-    TArray<uint8> Frame;
-    Frame.Add(0x8A); // FIN + Pong
-    Frame.Add(static_cast<uint8>(Payload.Num()));
-    Frame.Append(Payload);
-    SendRaw(Frame);
+    const TSharedPtr<FJsonValue> Value = Filter.TryGetField(Field);
+    if (!Value.IsValid() || Value->IsNull()) return true;
+
+    const TArray<TSharedPtr<FJsonValue>>* Items;
+    if (!Value->TryGetArray(Items)) return false;
+
+    for (const TSharedPtr<FJsonValue>& Item : *Items)
+    {
+        FString Text;
+        if (!Item->TryGetString(Text) || Text.IsEmpty()) return false;
+        Out.Add(MoveTemp(Text));
+    }
+    return true;
 }
 
-void FWsConnection::SendRaw(const TArray<uint8>& Data)
+void FWsConnection::HandleTextMessage(TConstArrayView<uint8> Payload)
 {
-    if (!Socket) return;
+    const FString Text(FUTF8ToTCHAR(reinterpret_cast<const ANSICHAR*>(Payload.GetData()), Payload.Num()));
+
+    TSharedPtr<FJsonObject> Message;
+    auto Reader = TJsonReaderFactory<>::Create(Text);
+    if (!FJsonSerializer::Deserialize(Reader, Message) || !Message.IsValid())
+    {
+        SendReply(TEXT("ERROR"), FString(), TEXT("Invalid JSON"));
+        return;
+    }
+
+    FString Type;
+    Message->TryGetStringField(TEXT("type"), Type);
+    if (Type == TEXT("command"))
+    {
+        HandleCommandMessage(*Message);
+        return;
+    }
 
-    int32 BytesSent = 0;
-    Socket->Send(Data.GetData(), Data.Num(), BytesSent);
+    FString Id;
+    if (!Message->TryGetStringField(TEXT("id"), Id) || Id.IsEmpty())
+    {
+        SendReply(TEXT("ERROR"), FString(), TEXT("Missing required field: id"));
+        return;
+    }
+
+    FWsSubscriptionIndex& Index = Server.GetSubscriptions();
+
+    if (Type == TEXT("subscribe"))
+    {
+        FWsSubscriptionFilter Filter;
+        const TSharedPtr<FJsonObject>* FilterObj;
+        if (Message->TryGetObjectField(TEXT("filter"), FilterObj))
+        {
+            if (!ReadFilterSet(**FilterObj, TEXT("commandTypes"), Filter.CommandTypes) ||
+                !ReadFilterSet(**FilterObj, TEXT("commandIds"), Filter.CommandIds) ||
+                !ReadFilterSet(**FilterObj, TEXT("issuers"), Filter.Issuers) ||
+                !ReadFilterSet(**FilterObj, TEXT("buildingIds"), Filter.BuildingIds))
+            {
+                SendReply(TEXT("ERROR"), Id, TEXT("Filter fields must be arrays of non-empty strings"));
+                return;
+            }
+        }
+
+        if (Filter.NumValues() > MaxFilterValues)
+        {
+            SendReply(TEXT("ERROR"), Id, FString::Printf(TEXT("Filter exceeds %d values"), MaxFilterValues));
+            return;
+        }
+
+        // Replacing an existing id never counts against the limit
+        if (NumSubscriptions.Load() >= MaxSubscriptionsPerConnection && Index.Remove(this, Id) == INDEX_NONE)
+        {
+            SendReply(TEXT("ERROR"), Id,
+                FString::Printf(TEXT("At most %d subscriptions per connection"), MaxSubscriptionsPerConnection));
+            return;
+        }
+
+        NumSubscriptions = Index.Add(this, Id, MoveTemp(Filter));
+        SendReply(TEXT("SUBSCRIBED"), Id);
+    }
+    else if (Type == TEXT("unsubscribe"))
+    {
+        const int32 Remaining = Index.Remove(this, Id);
+        if (Remaining == INDEX_NONE)
+        {
+            SendReply(TEXT("ERROR"), Id, TEXT("Unknown subscription"));
+            return;
+        }
+
+        NumSubscriptions = Remaining;
+        SendReply(TEXT("UNSUBSCRIBED"), Id);
+    }
+    else
+    {
+        SendReply(TEXT("ERROR"), Id, FString::Printf(TEXT("Unknown message type '%s'"), *Type));
+    }
+}
+
+void FWsConnection::HandleCommandMessage(const FJsonObject& Message)
+{
+    FControlCommandRequest Request;
+    if (!Message.TryGetStringField(TEXT("requestId"), Request.RequestId) ||
+        Request.RequestId.IsEmpty() || Request.RequestId.Len() > MaxRequestIdLength)
+    {
+        SendReply(TEXT("ERROR"), FString(),
+            FString::Printf(TEXT("requestId must be 1 to %d characters"), MaxRequestIdLength));
+        return;
+    }
+
+    if (!Message.TryGetStringField(TEXT("commandType"), Request.Type))
+    {
+        SendReply(TEXT("ERROR"), Request.RequestId, TEXT("Missing required field: commandType"));
+        return;
+    }
+
+    const TSharedPtr<FJsonObject>* PayloadObj;
+    if (Message.TryGetObjectField(TEXT("payload"), PayloadObj))
+    {
+        Request.Payload = *PayloadObj;
+    }
+
+    // A client resending after a reconnect reuses its key so the command runs once
+    if (!Message.TryGetStringField(TEXT("idempotencyKey"), Request.IdempotencyKey) || Request.IdempotencyKey.IsEmpty())
+    {
+        Request.IdempotencyKey = FGuid::NewGuid().ToString();
+    }
+
+    Request.Issuer = Issuer;
+    Request.StreamId = StreamId;
+    const FControlCommand Command = Server.SubmitCommand(Request);
+
+    // Same fields as the HTTP response, tagged with the client's correlation ID
+    auto Ack = MakeShared<FJsonObject>();
+    Ack->SetStringField(TEXT("event"), TEXT("COMMAND_ACK"));
+    Ack->SetStringField(TEXT("requestId"), Request.RequestId);
+    Ack->Values.Append(Command.ToResponseJson()->Values);
+    SendEvent(Ack);
+}
+
+void FWsConnection::SendReply(const FString& Event, const FString& Id, const FString& Error)
+{
+    auto Reply = MakeShared<FJsonObject>();
+    Reply->SetStringField(TEXT("event"), Event);
+    Reply->SetStringField(TEXT("id"), Id);
+    if (!Error.IsEmpty())
+    {
+        Reply->SetStringField(TEXT("error"), Error);
+    }
+
+    SendEvent(Reply);
+}
+
+void FWsConnection::SendEvent(const TSharedRef<FJsonObject>& Event)
+{
+    if (Encoding == EWsEncoding::Cbor)
+    {
+        TArray<uint8> Cbor;
+        FControlEventCbor::Encode(*Event, Cbor);
+        SendFrame(EncodeFrame(0x82, Cbor.GetData(), Cbor.Num())); // FIN + Binary
+        return;
+    }
+    Send(JsonToString(Event));
+}
+
+void FWsConnection::SendPong(TConstArrayView<uint8> Payload)
+{
+    TSharedRef<TArray<uint8>> Frame = MakeShared<TArray<uint8>>();
+    Frame->Add(0x8A); // FIN + Pong
+    Frame->Add(static_cast<uint8>(Payload.Num()));
+    Frame->Append(Payload.GetData(), Payload.Num());
+    SendFrame(Frame);
+}
+
+void FWsConnection::SendPing(double Now)
+{
+    // The payload is the heartbeat number, so a stale or unsolicited pong is not mistaken for this one
+    ++PingNumber;
+    PingSentTime = Now;
+
+    TSharedRef<TArray<uint8>> Frame = MakeShared<TArray<uint8>>();
+    Frame->Add(0x89); // FIN + Ping
+    Frame->Add(sizeof(PingNumber));
+    for (int32 i = 7; i >= 0; --i)
+    {
+        Frame->Add(static_cast<uint8>(PingNumber >> (i * 8)));
+    }
+    SendFrame(Frame);
+}
+
+void FWsConnection::HandlePong(TConstArrayView<uint8> Payload)
+{
+    if (PingSentTime <= 0.0 || Payload.Num() != sizeof(PingNumber))
+    {
+        return;
+    }
+
+    uint64 Number = 0;
+    for (const uint8 Byte : Payload)
+    {
+        Number = (Number << 8) | Byte;
+    }
+    if (Number != PingNumber)
+    {
+        return;
+    }
+
+    // Smoothed as in RFC 6298: gains of 1/8 for the mean and 1/4 for the variation
+    const int64 SampleUs = static_cast<int64>((FPlatformTime::Seconds() - PingSentTime) * 1e6);
+    const int64 Smoothed = SmoothedRttUs.Load();
+    if (Smoothed < 0)
+    {
+        SmoothedRttUs = SampleUs;
+        RttVarianceUs = SampleUs / 2;
+    }
+    else
+    {
+        RttVarianceUs = (3 * RttVarianceUs.Load() + FMath::Abs(Smoothed - SampleUs)) / 4;
+        SmoothedRttUs = (7 * Smoothed + SampleUs) / 8;
+    }
+
+    PingSentTime = 0.0;
+    MissedPongs = 0;
+}
+
+bool FWsConnection::FlushSendQueue(bool& bOutProgress)
+{
+    if (!Socket) return false;
+
+    for (;;)
+    {
+        if (!SendHead.IsValid())
+        {
+            if (!SendQueue.Dequeue(SendHead))
+            {
+                return true;
+            }
+            SendHeadOffset = 0;
+
+            if (Deflate.IsValid())
+            {
+                const int32 Before = SendHead->Num();
+                SendHead = CompressFrame(SendHead);
+                QueuedBytes += SendHead->Num() - Before;
+            }
+        }
+
+        // Partial writes resume at the same offset, so frames are never split or interleaved
+        int32 BytesSent = 0;
+        const ESocketIoResult Result = FSocketReactor::SendSome(Socket,
+            SendHead->GetData() + SendHeadOffset, SendHead->Num() - SendHeadOffset, BytesSent);
+        if (Result == ESocketIoResult::Closed)
+        {
+            return false;
+        }
+
+        SendHeadOffset += BytesSent;
+        QueuedBytes -= BytesSent;
+        bOutProgress |= BytesSent > 0;
+        if (SendHeadOffset < SendHead->Num())
+        {
+            return true;
+        }
+        SendHead.Reset();
+        --QueuedFrames;
+    }
 }
@@ -2,50 +2,223 @@
 
 #include "CoreMinimal.h"
 #include "Sockets.h"
+#include "Containers/Queue.h"
+#include "Net/SocketReactor.h"
+#include "WsDeflate.h"
+#include "WsFrameDecoder.h"
+
+class FWsServer;
+
+/** An encoded frame: immutable once built, shared by every connection that sends it */
+using FWsFrameRef = TSharedRef<const TArray<uint8>>;
+
+/** How events are serialized for a client, chosen by Sec-WebSocket-Protocol */
+enum class EWsEncoding : uint8
+{
+    /** Text frames of JSON; the default */
+    Json,
+    /** Binary frames of integer-keyed CBOR (see FControlEventCbor) */
+    Cbor
+};
+
+/** What the upgrade handshake settled for one client */
+struct FWsSessionOptions
+{
+    FString Token;
+    FWsDeflateParams Deflate;
+    EWsEncoding Encoding = EWsEncoding::Json;
+    /** Replay journaled events after this number (?since=); MAX_uint64 for live events only */
+    uint64 ResumeAfterSeq = MAX_uint64;
+};
 
 /**
  * Represents a single WebSocket client connection.
- * Handles RFC 6455 frame encoding/decoding.
+ * Handles RFC 6455 frame encoding/decoding. Owned by the socket reactor,
+ * which does all reads and writes; other threads only queue frames. The
+ * queue is bounded, and a client that lets it grow past the high-water mark
+ * is disconnected on its next service pass. The server also pings each
+ * client on a schedule: pongs give a smoothed round-trip time, and a client
+ * that stops answering is dropped instead of silently absorbing broadcasts.
+ *
+ * Clients may narrow the event stream with text messages:
+ *   {"type":"subscribe","id":"panel","filter":{"commandTypes":[],"commandIds":[],"issuers":[],"buildingIds":[]}}
+ *   {"type":"unsubscribe","id":"panel"}
+ * Each is answered with a SUBSCRIBED, UNSUBSCRIBED or ERROR event. A client
+ * with no subscriptions receives every event. "issuers" takes token
+ * fingerprints (FTokenAuth::Fingerprint), never the tokens themselves.
+ *
+ * Commands may be submitted on the same socket:
+ *   {"type":"command","requestId":"r1","commandType":"TOGGLE_BUILDING","payload":{},"idempotencyKey":"..."}
+ * The COMMAND_ACK reply and every later status event of the command carry
+ * the requestId, and reach this client whatever its subscriptions.
+ *
+ * Control messages from the client are always JSON text; replies use the
+ * negotiated encoding. When permessage-deflate was negotiated, shared frames are compressed per
+ * connection as they reach the head of the queue, since each client's
+ * compressor carries its own history.
  */
-class FWsConnection : public TSharedFromThis<FWsConnection>
+class FWsConnection : public IReactorConnection, public TSharedFromThis<FWsConnection>
 {
 public:
-    FWsConnection(FSocket* InSocket, const FString& InToken);
-    ~FWsConnection();
+    FWsConnection(FSocket* InSocket, const FWsSessionOptions& InSession, FWsServer& InServer);
+    virtual ~FWsConnection();
+
+    // IReactorConnection
+    virtual EServiceResult Service(double Now) override;
+    virtual void OnClosed() override;
+    virtual double GetDeadline() const override;
+    virtual EServiceResult OnDeadline(double Now) override;
+    virtual FSocket* GetSocket() const override { return Socket; }
+    virtual bool WantsWrite() const override { return QueuedFrames.Load() > 0; }
 
     /** Check if the connection is still open */
-    bool IsOpen() const { return bOpen && Socket != nullptr; }
+    bool IsOpen() const { return bOpen; }
+
+    /** Outbound bytes that may wait for a slow reader before the connection overflows */
+    void SetMaxQueuedBytes(int64 InMaxQueuedBytes) { MaxQueuedBytes = InMaxQueuedBytes; }
+
+    /** True once a frame was refused because the client fell too far behind */
+    bool IsOverflowed() const { return bOverflowed; }
+
+    /** Frames and bytes waiting to be written, including the partially written head */
+    int32 GetQueuedFrames() const { return QueuedFrames; }
+    int64 GetQueuedBytes() const { return QueuedBytes; }
 
     /** Send a text message (UTF-8 JSON) */
     void Send(const FString& Message);
 
-    /** Close the connection */
+    /** Send an unjournaled event in the negotiated encoding (any thread) */
+    void SendEvent(const TSharedRef<FJsonObject>& Event);
+
+    /**
+     * Queue a frame built once by EncodeTextFrame (any thread, lock-free).
+     * Only a reference is queued; the reactor writes it on its next pass, so
+     * wake it afterwards. Frames beyond the high-water mark are dropped and
+     * the connection is marked overflowed.
+     */
+    void SendFrame(const FWsFrameRef& Frame);
+
+    /** Encode a text frame per RFC 6455 from UTF-8 bytes */
+    static FWsFrameRef EncodeTextFrame(const uint8* Utf8, int32 Len);
+
+    /** Encode a single-frame message; FirstByte carries FIN, RSV and the opcode */
+    static FWsFrameRef EncodeFrame(uint8 FirstByte, const uint8* Payload, int32 Len);
+
+    /**
+     * Ping the client every Interval seconds (0 disables); after MaxMissed
+     * pings in a row go unanswered the peer is considered dead and dropped.
+     */
+    void SetHeartbeat(float InInterval, int32 InMaxMissed);
+
+    /** Smoothed round-trip time and its variation from ping/pong, in microseconds; -1 before the first pong */
+    int64 GetSmoothedRttUs() const { return SmoothedRttUs; }
+    int64 GetRttVarianceUs() const { return RttVarianceUs; }
+
+    /** Pings sent since the last pong */
+    int32 GetMissedPongs() const { return MissedPongs; }
+
+    /** Messages smaller than this are sent uncompressed even when deflate is on */
+    void SetDeflateThreshold(int32 InThreshold) { DeflateThreshold = InThreshold; }
+
+    /** Serialization the client negotiated for events */
+    EWsEncoding GetEncoding() const { return Encoding; }
+
+    /** Whether permessage-deflate is in effect */
+    bool IsCompressed() const { return Deflate.IsValid(); }
+
+    /** Payload bytes handed to the compressor, and what it produced */
+    int64 GetDeflateBytesIn() const { return DeflateBytesIn; }
+    int64 GetDeflateBytesOut() const { return DeflateBytesOut; }
+
+    /** Send a close frame (best effort) and release the socket (reactor thread) */
     void Close(uint16 Code = 1000, const FString& Reason = TEXT(""));
 
-    /** Read and process incoming frames. Returns false if connection should be removed. */
-    bool Tick();
+    /** True once the client subscribed, so only matching events are sent */
+    bool HasSubscriptions() const { return NumSubscriptions.Load() > 0; }
+    int32 GetSubscriptionCount() const { return NumSubscriptions.Load(); }
 
-    /** Get the auth token this connection provided */
-    const FString& GetToken() const { return Token; }
+    /** Fingerprint of the auth token this connection provided (see FTokenAuth::Fingerprint) */
+    const FString& GetIssuer() const { return Issuer; }
+
+    /** Unique for the server's lifetime; commands submitted here carry it */
+    uint64 GetStreamId() const { return StreamId; }
 
 private:
-    /** Encode a text frame per RFC 6455 */
-    TArray<uint8> EncodeTextFrame(const FString& Text);
+    /** Process a complete message or control frame */
+    void ProcessFrame(uint8 Opcode, TConstArrayView<uint8> Payload);
+
+    /** Handle a subscribe, unsubscribe or command message */
+    void HandleTextMessage(TConstArrayView<uint8> Payload);
 
-    /** Decode a WebSocket frame. Returns opcode, or -1 on error. */
-    int32 DecodeFrame(const TArray<uint8>& Data, int32& OutPayloadStart, int32& OutPayloadLen, bool& OutMasked, uint8 OutMaskKey[4]);
+    /** Submit a command and acknowledge it with the client's requestId */
+    void HandleCommandMessage(const FJsonObject& Message);
 
-    /** Process a complete frame */
-    void ProcessFrame(uint8 Opcode, const TArray<uint8>& Payload);
+    /** Answer a subscription message with an event naming its id */
+    void SendReply(const FString& Event, const FString& Id, const FString& Error = FString());
 
     /** Send a pong frame */
-    void SendPong(const TArray<uint8>& Payload);
+    void SendPong(TConstArrayView<uint8> Payload);
 
-    /** Send raw bytes */
-    void SendRaw(const TArray<uint8>& Data);
+    /** Send a ping carrying the next heartbeat number (reactor thread) */
+    void SendPing(double Now);
 
+    /** Fold the RTT of the pong answering the outstanding ping into the estimate */
+    void HandlePong(TConstArrayView<uint8> Payload);
+
+    /** Decode and handle every complete message received so far */
+    void ProcessReceived();
+
+    /** Replace an uncompressed data frame with its compressed form, if worthwhile */
+    TSharedPtr<const TArray<uint8>> CompressFrame(const TSharedPtr<const TArray<uint8>>& Frame);
+
+    /** Write queued frames until the socket would block. Returns false if it closed. */
+    bool FlushSendQueue(bool& bOutProgress);
+
+    /** Reactor-thread only */
     FSocket* Socket;
-    FString Token;
-    bool bOpen;
-    TArray<uint8> ReceiveBuffer;
+    FString Issuer;
+    EWsEncoding Encoding;
+    FWsServer& Server;
+    const uint64 StreamId;
+    FWsFrameDecoder Decoder;
+
+    /** Reused for inflated messages */
+    TArray<uint8> Inflated;
+
+    TAtomic<bool> bOpen;
+
+    /** Outbound frames, produced by any thread and consumed by the reactor */
+    TQueue<TSharedPtr<const TArray<uint8>>, EQueueMode::Mpsc> SendQueue;
+
+    /** Reactor-thread only: the head frame, possibly partially written */
+    TSharedPtr<const TArray<uint8>> SendHead;
+    int32 SendHeadOffset = 0;
+
+    int64 MaxQueuedBytes = 1024 * 1024;
+    TAtomic<int32> QueuedFrames { 0 };
+    TAtomic<int64> QueuedBytes { 0 };
+    TAtomic<bool> bOverflowed { false };
+
+    /** Written by the reactor, read by publishers */
+    TAtomic<int32> NumSubscriptions { 0 };
+
+    /** Reactor-thread only; null unless permessage-deflate was negotiated */
+    TUniquePtr<FWsDeflate> Deflate;
+    int32 DeflateThreshold = 256;
+
+    /** Read by /control/v1/stats */
+    TAtomic<int64> DeflateBytesIn { 0 };
+    TAtomic<int64> DeflateBytesOut { 0 };
+
+    /** Reactor-thread only: heartbeat schedule and the ping awaiting its pong */
+    float PingInterval = 0.0f;
+    int32 MaxMissedPongs = 2;
+    double NextPingTime = 0.0;
+    double PingSentTime = 0.0;
+    uint64 PingNumber = 0;
+
+    /** Written by the reactor, read by /control/v1/stats */
+    TAtomic<int32> MissedPongs { 0 };
+    TAtomic<int64> SmoothedRttUs { -1 };
+    TAtomic<int64> RttVarianceUs { 0 };
 };
@@ -0,0 +1,264 @@
+#include "WsDeflate.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "zlib.h"
+THIRD_PARTY_INCLUDES_END
+
+DEFINE_LOG_CATEGORY_STATIC(LogWsDeflate, Log, All);
+
+// Every message ends with an empty stored block; the wire format omits it (RFC 7692 7.2.1)
+static constexpr uint8 DeflateTail[4] = { 0x00, 0x00, 0xFF, 0xFF };
+
+// zlib cannot produce raw deflate with a 256-byte window
+static constexpr int32 MinWindowBits = 9;
+
+/** Parse "name=value" (value optionally quoted); false for a malformed number */
+static bool ParseWindowBits(const FString& Value, int32& OutBits)
+{
+    const FString Digits = Value.TrimQuotes();
+    if (Digits.IsEmpty() || !Digits.IsNumeric()) return false;
+    OutBits = FCString::Atoi(*Digits);
+    return OutBits >= 8 && OutBits <= 15;
+}
+
+bool FWsDeflateParams::Negotiate(const FString& Offers, int32 MaxWindowBits, FWsDeflateParams& Out, FString& OutResponse)
+{
+    MaxWindowBits = FMath::Clamp(MaxWindowBits, MinWindowBits, 15);
+
+    TArray<FString> Extensions;
+    Offers.ParseIntoArray(Extensions, TEXT(","));
+
+    for (const FString& Extension : Extensions)
+    {
+        TArray<FString> Parts;
+        Extension.ParseIntoArray(Parts, TEXT(";"));
+        if (Parts.Num() == 0 || !Parts[0].TrimStartAndEnd().Equals(TEXT("permessage-deflate"), ESearchCase::IgnoreCase))
+        {
+            continue;
+        }
+
+        FWsDeflateParams Params;
+        Params.bEnabled = true;
+        Params.ServerWindowBits = MaxWindowBits;
+        bool bOfferedServerBits = false;
+        bool bAcceptable = true;
+        TSet<FString> Seen;
+
+        for (int32 i = 1; i < Parts.Num() && bAcceptable; ++i)
+        {
+            FString Name;
+            FString Value;
+            if (!Parts[i].Split(TEXT("="), &Name, &Value))
+            {
+                Name = Parts[i];
+            }
+            Name.TrimStartAndEndInline();
+            Value.TrimStartAndEndInline();
+
+            // A repeated parameter invalidates the offer
+            bool bDuplicate = false;
+            Seen.Add(Name.ToLower(), &bDuplicate);
+            if (bDuplicate)
+            {
+                bAcceptable = false;
+            }
+            else if (Name.Equals(TEXT("server_no_context_takeover"), ESearchCase::IgnoreCase))
+            {
+                Params.bServerNoContextTakeover = true;
+            }
+            else if (Name.Equals(TEXT("client_no_context_takeover"), ESearchCase::IgnoreCase))
+            {
+                Params.bClientNoContextTakeover = true;
+            }
+            else if (Name.Equals(TEXT("server_max_window_bits"), ESearchCase::IgnoreCase))
+            {
+                int32 Bits = 0;
+                bAcceptable = ParseWindowBits(Value, Bits) && Bits >= MinWindowBits;
+                Params.ServerWindowBits = FMath::Min(Params.ServerWindowBits, Bits);
+                bOfferedServerBits = true;
+            }
+            else if (Name.Equals(TEXT("client_max_window_bits"), ESearchCase::IgnoreCase))
+            {
+                // Our inflater always allocates the full window, so any client window is fine
+                int32 Bits = 0;
+                bAcceptable = Value.IsEmpty() || ParseWindowBits(Value, Bits);
+            }
+            else
+            {
+                bAcceptable = false;
+            }
+        }
+
+        if (!bAcceptable)
+        {
+            continue;
+        }
+
+        OutResponse = TEXT("permessage-deflate");
+        if (Params.bServerNoContextTakeover)
+        {
+            OutResponse += TEXT("; server_no_context_takeover");
+        }
+        if (Params.bClientNoContextTakeover)
+        {
+            OutResponse += TEXT("; client_no_context_takeover");
+        }
+        if (bOfferedServerBits || Params.ServerWindowBits < 15)
+        {
+            OutResponse += FString::Printf(TEXT("; server_max_window_bits=%d"), Params.ServerWindowBits);
+        }
+
+        Out = Params;
+        return true;
+    }
+
+    return false;
+}
+
+struct FWsDeflate::FStreams
+{
+    z_stream Deflater;
+    z_stream Inflater;
+    bool bDeflaterReady = false;
+    bool bInflaterReady = false;
+};
+
+FWsDeflate::FWsDeflate(const FWsDeflateParams& InParams)
+    : Params(InParams)
+    , Streams(MakeUnique<FStreams>())
+{
+    FMemory::Memzero(Streams->Deflater);
+    FMemory::Memzero(Streams->Inflater);
+
+    // Negative window bits select raw deflate, without zlib header or checksum
+    Streams->bDeflaterReady = deflateInit2(&Streams->Deflater, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+        -FMath::Max(Params.ServerWindowBits, MinWindowBits), 8, Z_DEFAULT_STRATEGY) == Z_OK;
+    Streams->bInflaterReady = inflateInit2(&Streams->Inflater, -15) == Z_OK;
+
+    if (!Streams->bDeflaterReady || !Streams->bInflaterReady)
+    {
+        UE_LOG(LogWsDeflate, Error, TEXT("Failed to initialize zlib streams"));
+    }
+}
+
+FWsDeflate::~FWsDeflate()
+{
+    if (Streams->bDeflaterReady)
+    {
+        deflateEnd(&Streams->Deflater);
+    }
+    if (Streams->bInflaterReady)
+    {
+        inflateEnd(&Streams->Inflater);
+    }
+}
+
+bool FWsDeflate::Compress(const uint8* Data, int32 Len, TArray<uint8>& Out)
+{
+    if (!Streams->bDeflaterReady) return false;
+
+    z_stream& Z = Streams->Deflater;
+    Z.next_in = const_cast<Bytef*>(Data);
+    Z.avail_in = static_cast<uInt>(Len);
+
+    Out.SetNumUninitialized(static_cast<int32>(deflateBound(&Z, Len)) + 16);
+    int32 Written = 0;
+
+    // A sync flush emits everything buffered; it is complete once output space is left over
+    for (;;)
+    {
+        Z.next_out = Out.GetData() + Written;
+        Z.avail_out = static_cast<uInt>(Out.Num() - Written);
+
+        const int32 Result = deflate(&Z, Z_SYNC_FLUSH);
+        if (Result != Z_OK && Result != Z_BUF_ERROR)
+        {
+            return false;
+        }
+
+        Written = Out.Num() - static_cast<int32>(Z.avail_out);
+        if (Z.avail_out > 0)
+        {
+            break;
+        }
+        Out.SetNumUninitialized(Out.Num() * 2);
+    }
+
+    if (Params.bServerNoContextTakeover)
+    {
+        deflateReset(&Z);
+    }
+
+    if (Written < 4 || FMemory::Memcmp(Out.GetData() + Written - 4, DeflateTail, 4) != 0)
+    {
+        return false;
+    }
+    Out.SetNum(Written - 4, false);
+    return true;
+}
+
+bool FWsDeflate::Decompress(const uint8* Data, int32 Len, int32 MaxBytes, TArray<uint8>& Out)
+{
+    if (!Streams->bInflaterReady) return false;
+
+    TArray<uint8> Input;
+    Input.Reserve(Len + 4);
+    Input.Append(Data, Len);
+    Input.Append(DeflateTail, 4);
+
+    z_stream& Z = Streams->Inflater;
+    Z.next_in = Input.GetData();
+    Z.avail_in = static_cast<uInt>(Input.Num());
+
+    Out.SetNumUninitialized(FMath::Min(FMath::Max(Len * 4, 256), MaxBytes + 1));
+    int32 Written = 0;
+    bool bOk = true;
+
+    for (;;)
+    {
+        Z.next_out = Out.GetData() + Written;
+        Z.avail_out = static_cast<uInt>(Out.Num() - Written);
+
+        const int32 Result = inflate(&Z, Z_SYNC_FLUSH);
+        Written = Out.Num() - static_cast<int32>(Z.avail_out);
+
+        if (Written > MaxBytes)
+        {
+            bOk = false;
+            break;
+        }
+        if (Result == Z_STREAM_END)
+        {
+            // The client closed the stream with a final block; start afresh next message
+            inflateReset(&Z);
+            break;
+        }
+        if (Result != Z_OK && Result != Z_BUF_ERROR)
+        {
+            bOk = false;
+            break;
+        }
+        if (Z.avail_in == 0 && Z.avail_out > 0)
+        {
+            break;
+        }
+        if (Z.avail_out == 0)
+        {
+            Out.SetNumUninitialized(FMath::Min(Out.Num() * 2, MaxBytes + 1));
+        }
+    }
+
+    if (!bOk)
+    {
+        // The window is now inconsistent with the peer's; the caller must fail the connection
+        return false;
+    }
+
+    if (Params.bClientNoContextTakeover)
+    {
+        inflateReset(&Z);
+    }
+
+    Out.SetNum(Written, false);
+    return true;
+}
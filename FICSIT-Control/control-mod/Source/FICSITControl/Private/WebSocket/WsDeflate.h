@@ -0,0 +1,55 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** permessage-deflate parameters agreed for one connection (RFC 7692) */
+struct FWsDeflateParams
+{
+    bool bEnabled = false;
+
+    /** LZ77 window the server compresses with, 9..15 */
+    int32 ServerWindowBits = 15;
+
+    /** Reset the compressor after every message instead of keeping its history */
+    bool bServerNoContextTakeover = false;
+
+    /** The client resets its compressor per message, so we reset our inflater too */
+    bool bClientNoContextTakeover = false;
+
+    /**
+     * Pick the first acceptable permessage-deflate offer from a
+     * Sec-WebSocket-Extensions value. MaxWindowBits is our own limit (9..15).
+     * Returns false if no offer is acceptable; otherwise fills Out and the
+     * value for the response's Sec-WebSocket-Extensions header.
+     */
+    static bool Negotiate(const FString& Offers, int32 MaxWindowBits, FWsDeflateParams& Out, FString& OutResponse);
+};
+
+/**
+ * Per-connection permessage-deflate state: a raw-deflate compressor for
+ * outbound messages and an inflater for compressed client messages. With
+ * context takeover both keep their sliding window across messages, which is
+ * what makes repetitive JSON events shrink to a few bytes. Reactor thread only.
+ */
+class FWsDeflate
+{
+public:
+    explicit FWsDeflate(const FWsDeflateParams& InParams);
+    ~FWsDeflate();
+
+    FWsDeflate(const FWsDeflate&) = delete;
+    FWsDeflate& operator=(const FWsDeflate&) = delete;
+
+    /** Compress one message payload, without the trailing empty block. Returns false on error. */
+    bool Compress(const uint8* Data, int32 Len, TArray<uint8>& Out);
+
+    /** Inflate one compressed message; fails if the result would exceed MaxBytes */
+    bool Decompress(const uint8* Data, int32 Len, int32 MaxBytes, TArray<uint8>& Out);
+
+private:
+    FWsDeflateParams Params;
+
+    /** zlib streams, kept opaque so zlib.h stays out of this header */
+    struct FStreams;
+    TUniquePtr<FStreams> Streams;
+};
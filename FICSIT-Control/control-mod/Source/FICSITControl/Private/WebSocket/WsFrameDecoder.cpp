@@ -0,0 +1,265 @@
+#include "WsFrameDecoder.h"
+#include "Math/VectorRegister.h"
+
+// Largest frame header: 2 bytes, 8-byte extended length, 4-byte mask
+static constexpr int32 MaxHeaderBytes = 14;
+
+// Control frames carry at most this much payload and are never fragmented
+static constexpr uint64 MaxControlPayload = 125;
+
+// High bit of every byte in a word: any set means the word is not all ASCII
+static constexpr uint64 NonAsciiBits = 0x8080808080808080ull;
+
+FWsFrameDecoder::FWsFrameDecoder(int32 InMaxMessageBytes)
+    : MaxMessageBytes(InMaxMessageBytes)
+    , MaxBufferedBytes(InMaxMessageBytes + MaxHeaderBytes)
+{
+}
+
+ESocketIoResult FWsFrameDecoder::Receive(FSocket* Socket)
+{
+    // Drop what was decoded; only the unread part of a partial frame moves
+    if (ReadPos > 0)
+    {
+        Buffer.RemoveAt(0, ReadPos, false);
+        ReadPos = 0;
+    }
+    return FSocketReactor::RecvAvailable(Socket, Buffer, MaxBufferedBytes - Buffer.Num());
+}
+
+FWsFrameDecoder::EResult FWsFrameDecoder::Next(FWsDecodedMessage& Out)
+{
+    for (;;)
+    {
+        const int32 Available = Buffer.Num() - ReadPos;
+        if (Available < 2)
+        {
+            return EResult::NeedMore;
+        }
+
+        uint8* Data = Buffer.GetData() + ReadPos;
+        const bool bFin = (Data[0] & 0x80) != 0;
+        const bool bRsv1 = (Data[0] & 0x40) != 0;
+        const uint8 Opcode = Data[0] & 0x0F;
+        const bool bControl = (Opcode & 0x08) != 0;
+
+        if ((Data[1] & 0x80) == 0)
+        {
+            return Fail(1002, TEXT("Client frames must be masked"));
+        }
+        if ((Data[0] & 0x30) != 0 || (bRsv1 && (bControl || Opcode == 0x00 || !bAllowCompressed)))
+        {
+            return Fail(1002, TEXT("Unexpected RSV bits"));
+        }
+        if (Opcode > 0x02 && Opcode != 0x08 && Opcode != 0x09 && Opcode != 0x0A)
+        {
+            return Fail(1002, TEXT("Unknown opcode"));
+        }
+
+        // Lengths are checked against the limit as 64-bit values, before any narrowing
+        uint64 PayloadLen = Data[1] & 0x7F;
+        int32 HeaderLen = 2;
+        if (PayloadLen == 126)
+        {
+            if (Available < 4) return EResult::NeedMore;
+            PayloadLen = (static_cast<uint64>(Data[2]) << 8) | Data[3];
+            HeaderLen = 4;
+        }
+        else if (PayloadLen == 127)
+        {
+            if (Available < 10) return EResult::NeedMore;
+            PayloadLen = 0;
+            for (int32 i = 0; i < 8; ++i)
+            {
+                PayloadLen = (PayloadLen << 8) | Data[2 + i];
+            }
+            HeaderLen = 10;
+        }
+
+        if (bControl && (!bFin || PayloadLen > MaxControlPayload))
+        {
+            return Fail(1002, TEXT("Invalid control frame"));
+        }
+        if (PayloadLen > static_cast<uint64>(MaxMessageBytes))
+        {
+            return Fail(1009, TEXT("Message too big"));
+        }
+
+        const int32 Len = static_cast<int32>(PayloadLen);
+        const uint8* MaskKey = Data + HeaderLen;
+        HeaderLen += 4;
+        if (Available < HeaderLen + Len)
+        {
+            return EResult::NeedMore;
+        }
+
+        uint8* Payload = Data + HeaderLen;
+        Unmask(Payload, Len, MaskKey);
+        ReadPos += HeaderLen + Len;
+
+        // Control frames may arrive between the fragments of a message
+        if (bControl)
+        {
+            Out.Opcode = Opcode;
+            Out.bCompressed = false;
+            Out.Payload = TConstArrayView<uint8>(Payload, Len);
+            return EResult::Message;
+        }
+
+        if (Opcode == 0x00)
+        {
+            if (!bInFragmentedMessage)
+            {
+                return Fail(1002, TEXT("Unexpected continuation frame"));
+            }
+            if (Fragments.Num() + static_cast<int64>(Len) > MaxMessageBytes)
+            {
+                return Fail(1009, TEXT("Message too big"));
+            }
+
+            Fragments.Append(Payload, Len);
+            if (!bFin)
+            {
+                continue;
+            }
+
+            bInFragmentedMessage = false;
+            Out.Opcode = FragmentOpcode;
+            Out.bCompressed = bFragmentCompressed;
+            Out.Payload = Fragments;
+            return EResult::Message;
+        }
+
+        if (bInFragmentedMessage)
+        {
+            return Fail(1002, TEXT("Expected continuation frame"));
+        }
+
+        // The common case: a whole message in one frame, handed out where it lies
+        if (bFin)
+        {
+            Out.Opcode = Opcode;
+            Out.bCompressed = bRsv1;
+            Out.Payload = TConstArrayView<uint8>(Payload, Len);
+            return EResult::Message;
+        }
+
+        bInFragmentedMessage = true;
+        FragmentOpcode = Opcode;
+        bFragmentCompressed = bRsv1;
+        Fragments.Reset();
+        Fragments.Append(Payload, Len);
+    }
+}
+
+FWsFrameDecoder::EResult FWsFrameDecoder::Fail(uint16 Code, const TCHAR* Reason)
+{
+    CloseCode = Code;
+    Error = Reason;
+    return EResult::Error;
+}
+
+void FWsFrameDecoder::Unmask(uint8* Data, int64 Len, const uint8 Key[4])
+{
+    // The key repeats every 4 bytes, so it tiles a 16-byte register and an 8-byte word
+    uint32 Key32;
+    FMemory::Memcpy(&Key32, Key, sizeof(Key32));
+    const int32 KeyInt = static_cast<int32>(Key32);
+    const VectorRegister4Int KeyVector = MakeVectorRegisterInt(KeyInt, KeyInt, KeyInt, KeyInt);
+    const uint64 Key64 = (static_cast<uint64>(Key32) << 32) | Key32;
+
+    int64 i = 0;
+    for (; i + 16 <= Len; i += 16)
+    {
+        VectorIntStore(VectorIntXor(VectorIntLoad(Data + i), KeyVector), Data + i);
+    }
+    for (; i + 8 <= Len; i += 8)
+    {
+        uint64 Word;
+        FMemory::Memcpy(&Word, Data + i, sizeof(Word));
+        Word ^= Key64;
+        FMemory::Memcpy(Data + i, &Word, sizeof(Word));
+    }
+    for (; i < Len; ++i)
+    {
+        Data[i] ^= Key[i & 3];
+    }
+}
+
+bool FWsFrameDecoder::IsValidUtf8(const uint8* Data, int64 Len)
+{
+    int64 i = 0;
+    while (i < Len)
+    {
+        // JSON control messages are almost all ASCII: skip it a word at a time
+        while (i + 8 <= Len)
+        {
+            uint64 Word;
+            FMemory::Memcpy(&Word, Data + i, sizeof(Word));
+            if ((Word & NonAsciiBits) != 0)
+            {
+                break;
+            }
+            i += 8;
+        }
+        if (i >= Len)
+        {
+            break;
+        }
+
+        const uint8 Lead = Data[i];
+        if (Lead < 0x80)
+        {
+            ++i;
+            continue;
+        }
+
+        int32 Continuation;
+        uint32 CodePoint;
+        uint32 Smallest;
+        if ((Lead & 0xE0) == 0xC0)
+        {
+            Continuation = 1;
+            CodePoint = Lead & 0x1F;
+            Smallest = 0x80;
+        }
+        else if ((Lead & 0xF0) == 0xE0)
+        {
+            Continuation = 2;
+            CodePoint = Lead & 0x0F;
+            Smallest = 0x800;
+        }
+        else if ((Lead & 0xF8) == 0xF0)
+        {
+            Continuation = 3;
+            CodePoint = Lead & 0x07;
+            Smallest = 0x10000;
+        }
+        else
+        {
+            return false;
+        }
+
+        if (Len - i <= Continuation)
+        {
+            return false;
+        }
+        for (int32 k = 1; k <= Continuation; ++k)
+        {
+            const uint8 Byte = Data[i + k];
+            if ((Byte & 0xC0) != 0x80)
+            {
+                return false;
+            }
+            CodePoint = (CodePoint << 6) | (Byte & 0x3F);
+        }
+
+        // Overlong forms, UTF-16 surrogates and values past Unicode are all invalid
+        if (CodePoint < Smallest || CodePoint > 0x10FFFF || (CodePoint >= 0xD800 && CodePoint <= 0xDFFF))
+        {
+            return false;
+        }
+        i += Continuation + 1;
+    }
+    return true;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Net/SocketReactor.h"
+
+/** A complete message or control frame, pointing into the decoder's buffers */
+struct FWsDecodedMessage
+{
+    /** Text (1), binary (2), close (8), ping (9) or pong (10) */
+    uint8 Opcode = 0;
+
+    /** RSV1 was set on the message's first frame (permessage-deflate) */
+    bool bCompressed = false;
+
+    /** Unmasked payload; valid until the next call to Next or Receive */
+    TConstArrayView<uint8> Payload;
+};
+
+/**
+ * Incremental RFC 6455 decoder for client frames.
+ * Bytes are received behind a read cursor and frames are consumed where they
+ * lie: payloads are unmasked in place, a vector register at a time, and
+ * handed out as views. Only the unread tail of a partial frame is ever moved,
+ * once per receive, instead of shifting the buffer after every frame.
+ * Fragmented messages are reassembled (control frames may interleave), and
+ * every protocol violation maps to the close code the connection should send.
+ * Reactor-thread only.
+ */
+class FWsFrameDecoder
+{
+public:
+    enum class EResult : uint8
+    {
+        /** No complete message buffered yet */
+        NeedMore,
+        /** Out holds a message */
+        Message,
+        /** Protocol violation; see GetCloseCode and GetError */
+        Error
+    };
+
+    explicit FWsFrameDecoder(int32 InMaxMessageBytes);
+
+    /** Accept RSV1 on data messages; only once permessage-deflate was negotiated */
+    void SetAllowCompressed(bool bInAllowCompressed) { bAllowCompressed = bInAllowCompressed; }
+
+    /** Read what the socket has; room is always left for one largest frame */
+    ESocketIoResult Receive(FSocket* Socket);
+
+    /** Decode the next complete message or control frame */
+    EResult Next(FWsDecodedMessage& Out);
+
+    /** Close code and reason for the last Error */
+    uint16 GetCloseCode() const { return CloseCode; }
+    const TCHAR* GetError() const { return Error; }
+
+    /** XOR Len bytes with the 4-byte masking key, in place */
+    static void Unmask(uint8* Data, int64 Len, const uint8 Key[4]);
+
+    /** True if the bytes are well-formed UTF-8 (no overlongs, surrogates or values past U+10FFFF) */
+    static bool IsValidUtf8(const uint8* Data, int64 Len);
+
+private:
+    EResult Fail(uint16 Code, const TCHAR* Reason);
+
+    /** Received bytes; everything before ReadPos was already decoded */
+    TArray<uint8> Buffer;
+    int32 ReadPos = 0;
+
+    /** The message being reassembled from fragments */
+    TArray<uint8> Fragments;
+    uint8 FragmentOpcode = 0;
+    bool bFragmentCompressed = false;
+    bool bInFragmentedMessage = false;
+
+    int32 MaxMessageBytes;
+    int32 MaxBufferedBytes;
+    bool bAllowCompressed = false;
+
+    uint16 CloseCode = 1000;
+    const TCHAR* Error = TEXT("");
+};
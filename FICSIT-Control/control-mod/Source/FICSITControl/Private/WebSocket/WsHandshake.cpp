@@ -0,0 +1,105 @@
+#include "WsHandshake.h"
+#include "WsServer.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWsHandshake, Log, All);
+
+FWsHandshake::FWsHandshake(FSocket* InSocket, FWsServer& InServer)
+    : Socket(InSocket)
+    , Server(InServer)
+    , Deadline(FPlatformTime::Seconds() + InServer.GetHandshakeTimeout())
+{
+    Server.OnHandshakeStarted();
+}
+
+FWsHandshake::~FWsHandshake()
+{
+    OnClosed();
+    Server.OnHandshakeEnded();
+}
+
+EServiceResult FWsHandshake::Service(double Now)
+{
+    if (!Socket) return EServiceResult::Close;
+
+    // Phase 2: flush the 101 response, then upgrade in place
+    if (Response.Num() > 0)
+    {
+        int32 BytesSent = 0;
+        const ESocketIoResult Result = FSocketReactor::SendSome(Socket,
+            Response.GetData() + ResponseOffset, Response.Num() - ResponseOffset, BytesSent);
+        if (Result == ESocketIoResult::Closed)
+        {
+            return EServiceResult::Close;
+        }
+
+        ResponseOffset += BytesSent;
+        if (ResponseOffset < Response.Num())
+        {
+            return BytesSent > 0 ? EServiceResult::Busy : EServiceResult::Idle;
+        }
+
+        Upgraded = Server.AddConnection(Socket, Session);
+        Socket = nullptr;
+        return EServiceResult::Upgrade;
+    }
+
+    // Phase 1: buffer the upgrade request; the reactor enforces Deadline
+    const int32 MaxHandshakeBytes = Server.GetMaxHandshakeBytes();
+    const int32 Before = ReceiveBuffer.Num();
+    if (FSocketReactor::RecvAvailable(Socket, ReceiveBuffer, MaxHandshakeBytes - Before) == ESocketIoResult::Closed)
+    {
+        return EServiceResult::Close;
+    }
+
+    if (ReceiveBuffer.Num() == Before)
+    {
+        return EServiceResult::Idle;
+    }
+
+    // Wait for the blank line that ends the request headers
+    const int32 Num = ReceiveBuffer.Num();
+    bool bComplete = false;
+    for (int32 i = FMath::Max(0, Before - 3); i + 3 < Num; ++i)
+    {
+        if (ReceiveBuffer[i] == '\r' && ReceiveBuffer[i + 1] == '\n' &&
+            ReceiveBuffer[i + 2] == '\r' && ReceiveBuffer[i + 3] == '\n')
+        {
+            bComplete = true;
+            break;
+        }
+    }
+
+    if (!bComplete)
+    {
+        return Num >= MaxHandshakeBytes ? EServiceResult::Close : EServiceResult::Busy;
+    }
+
+    const FString Request(Num, UTF8_TO_TCHAR(reinterpret_cast<const char*>(ReceiveBuffer.GetData())));
+
+    FString ResponseText;
+    if (!Server.BuildHandshakeResponse(Request, Session, ResponseText))
+    {
+        UE_LOG(LogWsHandshake, Warning, TEXT("WebSocket handshake failed"));
+        return EServiceResult::Close;
+    }
+
+    FTCHARToUTF8 Utf8Response(*ResponseText);
+    Response.Append(reinterpret_cast<const uint8*>(Utf8Response.Get()), Utf8Response.Length());
+    return Service(Now);
+}
+
+EServiceResult FWsHandshake::OnDeadline(double Now)
+{
+    UE_LOG(LogWsHandshake, Verbose, TEXT("WebSocket handshake timed out"));
+    Server.OnHandshakeTimedOut();
+    return EServiceResult::Close;
+}
+
+void FWsHandshake::OnClosed()
+{
+    if (Socket)
+    {
+        FSocketReactor::DestroySocket(Socket);
+        Socket = nullptr;
+    }
+}
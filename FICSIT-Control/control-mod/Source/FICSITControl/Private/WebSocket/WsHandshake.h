@@ -0,0 +1,42 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Sockets.h"
+#include "Net/SocketReactor.h"
+#include "WsConnection.h"
+
+class FWsServer;
+
+/**
+ * A freshly accepted WebSocket socket waiting for its HTTP upgrade request.
+ * Runs on the reactor: buffers the request without blocking, writes the
+ * 101 response, then upgrades to an FWsConnection on the same socket.
+ */
+class FWsHandshake : public IReactorConnection
+{
+public:
+    FWsHandshake(FSocket* InSocket, FWsServer& InServer);
+    virtual ~FWsHandshake();
+
+    // IReactorConnection
+    virtual EServiceResult Service(double Now) override;
+    virtual void OnClosed() override;
+    virtual double GetDeadline() const override { return Deadline; }
+    virtual EServiceResult OnDeadline(double Now) override;
+    virtual TSharedPtr<IReactorConnection> TakeUpgrade() override { return MoveTemp(Upgraded); }
+    virtual FSocket* GetSocket() const override { return Socket; }
+    virtual bool WantsRead() const override { return Response.Num() == 0; }
+    virtual bool WantsWrite() const override { return Response.Num() > 0; }
+
+private:
+    FSocket* Socket;
+    FWsServer& Server;
+    /** The whole upgrade, including the 101 response, must finish by then */
+    double Deadline;
+
+    TArray<uint8> ReceiveBuffer;
+    TArray<uint8> Response;
+    int32 ResponseOffset = 0;
+    FWsSessionOptions Session;
+    TSharedPtr<IReactorConnection> Upgraded;
+};
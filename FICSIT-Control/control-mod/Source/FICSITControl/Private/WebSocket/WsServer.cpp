@@ -1,16 +1,30 @@
 #include "WsServer.h"
-#include "SocketSubsystem.h"
+#include "WsHandshake.h"
+#include "Net/SocketReactor.h"
 #include "Interfaces/IPv4/IPv4Endpoint.h"
 #include "Misc/Base64.h"
 #include "Misc/SecureHash.h"
-#include "Async/Async.h"
+#include "Misc/ScopeRWLock.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogWsServer, Log, All);
 
 // RFC 6455 magic GUID for Sec-WebSocket-Accept computation
 static const FString WebSocketMagicGuid = TEXT("258EAFA5-E914-47DA-95CA-C5AB0DC85B11");
 
+// Subprotocols selecting the event encoding; a client offering neither gets JSON
+static const TCHAR* const JsonSubprotocol = TEXT("ficsit-control.v1.json");
+static const TCHAR* const CborSubprotocol = TEXT("ficsit-control.v1.cbor");
+
+/** The journaled bytes of Event as one frame in the client's encoding */
+static FWsFrameRef EncodeEventFrame(const FControlEvent& Event, bool bCbor)
+{
+    return bCbor
+        ? FWsConnection::EncodeFrame(0x82, Event.Cbor.GetData(), Event.Cbor.Num()) // FIN + Binary
+        : FWsConnection::EncodeTextFrame(Event.Json.GetData(), Event.Json.Num());
+}
+
 FWsServer::FWsServer()
+    : Connections(MakeShared<FWsConnectionList>())
 {
 }
 
@@ -19,20 +33,21 @@ FWsServer::~FWsServer()
     Stop();
 }
 
-bool FWsServer::Start(int32 Port, FTokenAuth* InAuth)
+bool FWsServer::Start(int32 Port, FTokenAuth* InAuth, TSharedRef<FSocketReactor> InReactor)
 {
     if (bRunning) return true;
 
     Auth = InAuth;
+    Reactor = InReactor;
 
     FIPv4Endpoint Endpoint(FIPv4Address::Any, Port);
-    Listener = MakeUnique<FTcpListener>(Endpoint, FTimespan::FromSeconds(1.0), false);
-    Listener->OnConnectionAccepted().BindRaw(this, &FWsServer::HandleConnection);
+    ListenerId = Reactor->AddListener(Endpoint, TEXT("FICSITControl WebSocket"),
+        FSocketReactor::FOnAccepted::CreateRaw(this, &FWsServer::HandleConnection));
 
-    if (!Listener->Init())
+    if (ListenerId == INDEX_NONE)
     {
         UE_LOG(LogWsServer, Error, TEXT("Failed to start WebSocket server on port %d"), Port);
-        Listener.Reset();
+        Reactor.Reset();
         return false;
     }
 
@@ -41,120 +56,351 @@ bool FWsServer::Start(int32 Port, FTokenAuth* InAuth)
     return true;
 }
 
+bool FWsServer::StartLocal(const FString& Path, int32 FileMode)
+{
+    if (!bRunning || !Reactor.IsValid()) return false;
+
+    LocalListenerId = Reactor->AddLocalListener(Path, FileMode, TEXT("FICSITControl WebSocket (local)"),
+        FSocketReactor::FOnAccepted::CreateRaw(this, &FWsServer::HandleConnection));
+
+    if (LocalListenerId == INDEX_NONE)
+    {
+        UE_LOG(LogWsServer, Error, TEXT("Failed to start WebSocket server on %s"), *Path);
+        return false;
+    }
+
+    UE_LOG(LogWsServer, Log, TEXT("WebSocket server listening on %s"), *Path);
+    return true;
+}
+
 void FWsServer::Stop()
 {
     bRunning = false;
 
+    // Closes handshakes and clients (1001) with the listening sockets, on the
+    // reactor thread. Keep the reactor reference: publishers may still wake it.
+    if (Reactor.IsValid())
+    {
+        Reactor->RemoveListener(ListenerId);
+        Reactor->RemoveListener(LocalListenerId);
+        ListenerId = INDEX_NONE;
+        LocalListenerId = INDEX_NONE;
+    }
+
+    UpdateConnections([](FWsConnectionList& List) { List.Empty(); });
+
+    UE_LOG(LogWsServer, Log, TEXT("WebSocket server stopped"));
+}
+
+void FWsServer::BroadcastEvent(const FControlEvent& Event)
+{
+    // Events about specific commands only reach subscribers whose filter matches,
+    // and the connections that submitted them
+    TMap<const FWsConnection*, TBitArray<>> Matched;
+    TMap<uint64, TBitArray<>> Submitted;
+    const bool bRouted = Event.Topics.Num() > 0 && Subscriptions.Num() > 0;
+    if (bRouted)
     {
-        FScopeLock Lock(&ConnectionsMutex);
-        for (auto& Conn : Connections)
+        Subscriptions.Match(Event.Topics, Matched);
+
+        for (int32 i = 0; i < Event.Topics.Num(); ++i)
         {
-            if (Conn.IsValid() && Conn->IsOpen())
+            if (const uint64 StreamId = Event.Topics[i].StreamId)
             {
-                Conn->Close(1001, TEXT("Server shutting down"));
+                TBitArray<>* Own = Submitted.Find(StreamId);
+                if (!Own)
+                {
+                    Own = &Submitted.Add(StreamId, TBitArray<>(false, Event.Topics.Num()));
+                }
+                (*Own)[i] = true;
             }
         }
-        Connections.Empty();
     }
 
-    if (Listener.IsValid())
+    // One immutable frame per encoding, built on first use; each client queues a reference
+    TSharedPtr<const TArray<uint8>> JsonFrame;
+    TSharedPtr<const TArray<uint8>> CborFrame;
+
+    // Queue to the list current now, without locking; the reactor does the writes
+    const TSharedRef<const FWsConnectionList> Snapshot = SnapshotConnections();
+    for (const TSharedPtr<FWsConnection>& Conn : *Snapshot)
     {
-        Listener.Reset();
+        if (!Conn->IsOpen())
+        {
+            continue;
+        }
+
+        const bool bCbor = Conn->GetEncoding() == EWsEncoding::Cbor && Event.Cbor.Num() > 0;
+
+        if (bRouted && Conn->HasSubscriptions())
+        {
+            const TBitArray<>* Wanted = Matched.Find(Conn.Get());
+            const TBitArray<>* Own = Submitted.Find(Conn->GetStreamId());
+            TBitArray<> Combined;
+            if (Wanted && Own)
+            {
+                Combined = TBitArray<>::BitwiseOR(*Wanted, *Own, EBitwiseOperatorFlags::MaxSize);
+                Wanted = &Combined;
+            }
+            else if (!Wanted)
+            {
+                Wanted = Own;
+            }
+            if (!Wanted)
+            {
+                continue;
+            }
+
+            // A batch the client only partly wants is cut down to its commands
+            if (Event.CanSplit() && Wanted->CountSetBits() < Event.Topics.Num())
+            {
+                TArray<uint8> Subset;
+                Event.BuildSubset(*Wanted, bCbor, Subset);
+                Conn->SendFrame(bCbor
+                    ? FWsConnection::EncodeFrame(0x82, Subset.GetData(), Subset.Num())
+                    : FWsConnection::EncodeTextFrame(Subset.GetData(), Subset.Num()));
+                continue;
+            }
+        }
+
+        TSharedPtr<const TArray<uint8>>& Frame = bCbor ? CborFrame : JsonFrame;
+        if (!Frame.IsValid())
+        {
+            Frame = EncodeEventFrame(Event, bCbor);
+        }
+        Conn->SendFrame(Frame.ToSharedRef());
     }
 
-    UE_LOG(LogWsServer, Log, TEXT("WebSocket server stopped"));
+    WakeReactor();
 }
 
-void FWsServer::BroadcastCommandStatus(const FControlCommand& Command)
+void FWsServer::WakeReactor()
 {
-    FString Json = JsonToString(Command.ToEventJson());
-
-    FScopeLock Lock(&ConnectionsMutex);
-    for (auto& Conn : Connections)
+    if (Reactor.IsValid())
     {
-        if (Conn.IsValid() && Conn->IsOpen())
-        {
-            Conn->Send(Json);
-        }
+        Reactor->Wake();
     }
 }
 
-void FWsServer::Tick()
+TSharedRef<const FWsConnectionList> FWsServer::SnapshotConnections() const
+{
+    // Only a reference count changes hands; readers never block each other
+    FRWScopeLock Lock(ConnectionsPointerLock, SLT_ReadOnly);
+    return Connections;
+}
+
+void FWsServer::UpdateConnections(TFunctionRef<void(FWsConnectionList&)> Edit)
 {
     FScopeLock Lock(&ConnectionsMutex);
 
-    // Tick all connections and remove dead ones
-    Connections.RemoveAll([](const TSharedPtr<FWsConnection>& Conn)
+    // Build the next list aside; broadcasts in flight keep iterating the old one
+    TSharedRef<FWsConnectionList> Next = MakeShared<FWsConnectionList>(*SnapshotConnections());
+    Edit(*Next);
+    NumConnections = Next->Num();
+
+    // Swap under the pointer lock; the old list is released after it, by its last reader
+    TSharedRef<const FWsConnectionList> Previous = Next;
     {
-        if (!Conn.IsValid() || !Conn->IsOpen()) return true;
-        return !Conn->Tick();
-    });
+        FRWScopeLock PointerLock(ConnectionsPointerLock, SLT_Write);
+        Swap(Connections, Previous);
+    }
 }
 
-bool FWsServer::HandleConnection(FSocket* ClientSocket, const FIPv4Endpoint& Endpoint)
+TSharedPtr<IReactorConnection> FWsServer::HandleConnection(FSocket* ClientSocket)
 {
     if (!bRunning || !ClientSocket)
     {
-        if (ClientSocket)
-        {
-            ClientSocket->Close();
-            ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(ClientSocket);
-        }
-        return false;
+        return nullptr;
     }
 
-    // Perform handshake async to avoid blocking the listener
-    Async(EAsyncExecution::ThreadPool, [this, ClientSocket]()
+    // Over the cap: refuse before spending a handshake on it
+    if (GetConnectionCount() + NumHandshakes.Load() >= MaxConnections)
     {
-        FString Token;
-        if (PerformHandshake(ClientSocket, Token))
-        {
-            // Validate token
-            if (Auth && !Auth->ValidateToken(Token))
-            {
-                UE_LOG(LogWsServer, Warning, TEXT("WebSocket connection rejected: invalid token"));
-                // Send 4001 close
-                ClientSocket->Close();
-                ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(ClientSocket);
-                return;
-            }
+        UE_LOG(LogWsServer, Verbose, TEXT("Connection refused: %d open, %d in handshake"),
+            GetConnectionCount(), NumHandshakes.Load());
+        return nullptr;
+    }
 
-            auto Connection = MakeShared<FWsConnection>(ClientSocket, Token);
+    // The handshake is read and answered on the reactor without blocking
+    return MakeShared<FWsHandshake>(ClientSocket, *this);
+}
 
-            FScopeLock Lock(&ConnectionsMutex);
-            Connections.Add(Connection);
-            UE_LOG(LogWsServer, Log, TEXT("WebSocket client connected (total: %d)"), Connections.Num());
+TSharedRef<FJsonObject> FWsServer::GetStatsJson()
+{
+    const TSharedRef<const FWsConnectionList> Snapshot = SnapshotConnections();
+
+    // Per-client send queue depth, to spot the laggy subscriber
+    TArray<TSharedPtr<FJsonValue>> Queues;
+    int64 MaxQueued = 0;
+    int32 NumCompressed = 0;
+    int32 NumBinary = 0;
+    int64 DeflateIn = 0;
+    int64 DeflateOut = 0;
+    int64 MaxRttUs = 0;
+    int32 NumLagging = 0;
+    for (const TSharedPtr<FWsConnection>& Conn : *Snapshot)
+    {
+        auto Queue = MakeShared<FJsonObject>();
+        Queue->SetNumberField(TEXT("frames"), Conn->GetQueuedFrames());
+        Queue->SetNumberField(TEXT("bytes"), static_cast<double>(Conn->GetQueuedBytes()));
+        Queue->SetNumberField(TEXT("subscriptions"), Conn->GetSubscriptionCount());
+
+        // Round trip from ping/pong; null until the client has answered one
+        const int64 RttUs = Conn->GetSmoothedRttUs();
+        if (RttUs >= 0)
+        {
+            Queue->SetNumberField(TEXT("rttMs"), RttUs / 1000.0);
+            Queue->SetNumberField(TEXT("rttVarMs"), Conn->GetRttVarianceUs() / 1000.0);
+            MaxRttUs = FMath::Max(MaxRttUs, RttUs);
         }
         else
         {
-            UE_LOG(LogWsServer, Warning, TEXT("WebSocket handshake failed"));
-            ClientSocket->Close();
-            ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(ClientSocket);
+            Queue->SetField(TEXT("rttMs"), MakeShared<FJsonValueNull>());
+            Queue->SetField(TEXT("rttVarMs"), MakeShared<FJsonValueNull>());
         }
-    });
+        Queue->SetNumberField(TEXT("missedPongs"), Conn->GetMissedPongs());
+        NumLagging += Conn->GetMissedPongs() > 0 ? 1 : 0;
+        Queues.Add(MakeShared<FJsonValueObject>(Queue));
+        MaxQueued = FMath::Max(MaxQueued, Conn->GetQueuedBytes());
+
+        NumCompressed += Conn->IsCompressed() ? 1 : 0;
+        NumBinary += Conn->GetEncoding() == EWsEncoding::Cbor ? 1 : 0;
+        DeflateIn += Conn->GetDeflateBytesIn();
+        DeflateOut += Conn->GetDeflateBytesOut();
+    }
 
-    return true;
+    // Ratio is compressed / original over the payloads that were compressed
+    auto Compression = MakeShared<FJsonObject>();
+    Compression->SetBoolField(TEXT("enabled"), bDeflateEnabled);
+    Compression->SetNumberField(TEXT("clients"), NumCompressed);
+    Compression->SetNumberField(TEXT("bytesIn"), static_cast<double>(DeflateIn));
+    Compression->SetNumberField(TEXT("bytesOut"), static_cast<double>(DeflateOut));
+    Compression->SetNumberField(TEXT("ratio"), DeflateIn > 0 ? static_cast<double>(DeflateOut) / DeflateIn : 1.0);
+
+    auto Heartbeat = MakeShared<FJsonObject>();
+    Heartbeat->SetNumberField(TEXT("intervalSeconds"), PingInterval);
+    Heartbeat->SetNumberField(TEXT("maxMissedPongs"), MaxMissedPongs);
+    Heartbeat->SetNumberField(TEXT("clientsMissingPongs"), NumLagging);
+    Heartbeat->SetNumberField(TEXT("maxRttMs"), MaxRttUs / 1000.0);
+    Heartbeat->SetNumberField(TEXT("deadPeersDropped"), static_cast<double>(DeadPeersDropped.Load()));
+
+    auto Stats = MakeShared<FJsonObject>();
+    Stats->SetNumberField(TEXT("connections"), Snapshot->Num());
+    Stats->SetNumberField(TEXT("binaryClients"), NumBinary);
+    Stats->SetNumberField(TEXT("handshakes"), NumHandshakes.Load());
+    Stats->SetNumberField(TEXT("subscriptions"), Subscriptions.Num());
+    Stats->SetNumberField(TEXT("handshakeTimeouts"), static_cast<double>(HandshakeTimeouts.Load()));
+    Stats->SetNumberField(TEXT("slowClientEvictions"), static_cast<double>(SlowClientEvictions.Load()));
+    Stats->SetNumberField(TEXT("replayedEvents"), static_cast<double>(ReplayedEvents.Load()));
+    Stats->SetNumberField(TEXT("resyncs"), static_cast<double>(Resyncs.Load()));
+    Stats->SetNumberField(TEXT("commandsReceived"), static_cast<double>(CommandsReceived.Load()));
+    Stats->SetNumberField(TEXT("maxQueuedBytes"), static_cast<double>(MaxQueued));
+    Stats->SetNumberField(TEXT("queueLimitBytes"), static_cast<double>(MaxQueuedBytes));
+    Stats->SetArrayField(TEXT("sendQueues"), Queues);
+    Stats->SetObjectField(TEXT("compression"), Compression);
+    Stats->SetObjectField(TEXT("heartbeat"), Heartbeat);
+    return Stats;
 }
 
-bool FWsServer::PerformHandshake(FSocket* Socket, FString& OutToken)
+FControlCommand FWsServer::SubmitCommand(const FControlCommandRequest& Request)
 {
-    // Read the HTTP upgrade request
-    Socket->SetNonBlocking(false);
-    if (!Socket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromSeconds(5.0)))
+    if (!OnCommandReceived.IsBound())
     {
-        return false;
+        FControlCommand Unavailable;
+        Unavailable.Status = EControlCommandStatus::Failed;
+        Unavailable.Error = TEXT("Command router not available");
+        return Unavailable;
     }
 
-    TArray<uint8> Buffer;
-    Buffer.SetNumUninitialized(4096);
-    int32 BytesRead = 0;
-    if (!Socket->Recv(Buffer.GetData(), Buffer.Num(), BytesRead) || BytesRead <= 0)
+    ++CommandsReceived;
+    return OnCommandReceived.Execute(Request);
+}
+
+TSharedRef<FWsConnection> FWsServer::AddConnection(FSocket* Socket, const FWsSessionOptions& Session)
+{
+    auto Connection = MakeShared<FWsConnection>(Socket, Session, *this);
+    Connection->SetMaxQueuedBytes(MaxQueuedBytes);
+    Connection->SetDeflateThreshold(DeflateThreshold);
+    Connection->SetHeartbeat(PingInterval, MaxMissedPongs);
+
+    auto Register = [this, &Connection]()
     {
-        return false;
+        UpdateConnections([&Connection](FWsConnectionList& List) { List.Add(Connection); });
+        UE_LOG(LogWsServer, Log, TEXT("WebSocket client connected (total: %d)"), GetConnectionCount());
+    };
+
+    if (!EventJournal.IsValid())
+    {
+        Register();
+        return Connection;
     }
 
-    FString Request = FString(BytesRead, UTF8_TO_TCHAR(reinterpret_cast<const char*>(Buffer.GetData())));
+    // A number past the head was handed out before a restart
+    const uint64 AfterSeq = Session.ResumeAfterSeq;
+    const uint64 LastSeq = EventJournal->GetLastSeq();
+    const bool bStale = AfterSeq != MAX_uint64 && AfterSeq > LastSeq;
+
+    // Registered under the journal lock, so live events pick up exactly where the replay ends
+    EventJournal->Attach(AfterSeq, [&](const TArray<TSharedRef<const FControlEvent>>& Missed, bool bGap)
+    {
+        if (AfterSeq != MAX_uint64)
+        {
+            ReplayEvents(*Connection, AfterSeq, Missed.Num() > 0 ? Missed.Last()->Seq : LastSeq,
+                Missed, bGap || bStale);
+        }
+        Register();
+    });
+    return Connection;
+}
+
+void FWsServer::ReplayEvents(FWsConnection& Connection, uint64 AfterSeq, uint64 LastSeq,
+    const TArray<TSharedRef<const FControlEvent>>& Missed, bool bGap)
+{
+    const bool bCbor = Connection.GetEncoding() == EWsEncoding::Cbor;
+
+    // A backlog that would take most of the send queue is cheaper to refetch
+    int64 Bytes = 0;
+    for (const TSharedRef<const FControlEvent>& Event : Missed)
+    {
+        Bytes += bCbor && Event->Cbor.Num() > 0 ? Event->Cbor.Num() : Event->Json.Num();
+    }
+
+    if (!bGap && Bytes <= MaxQueuedBytes / 2)
+    {
+        for (const TSharedRef<const FControlEvent>& Event : Missed)
+        {
+            Connection.SendFrame(EncodeEventFrame(*Event, bCbor && Event->Cbor.Num() > 0));
+        }
+        ReplayedEvents += Missed.Num();
+        return;
+    }
+
+    // The client must refetch command state, then continue from LastSeq
+    auto Resync = MakeShared<FJsonObject>();
+    Resync->SetStringField(TEXT("event"), TEXT("RESYNC"));
+    Resync->SetNumberField(TEXT("since"), static_cast<double>(AfterSeq));
+    Resync->SetNumberField(TEXT("seq"), static_cast<double>(LastSeq));
+    Connection.SendEvent(Resync);
+    ++Resyncs;
+}
+
+void FWsServer::RemoveConnection(const FWsConnection* Connection)
+{
+    Subscriptions.RemoveAll(Connection);
+
+    UpdateConnections([Connection](FWsConnectionList& List)
+    {
+        List.RemoveAll([Connection](const TSharedPtr<FWsConnection>& Conn)
+        {
+            return Conn.Get() == Connection;
+        });
+    });
+    UE_LOG(LogWsServer, Log, TEXT("WebSocket client disconnected (total: %d)"), GetConnectionCount());
+}
 
+bool FWsServer::BuildHandshakeResponse(const FString& Request, FWsSessionOptions& OutSession, FString& OutResponse)
+{
+    FString& OutToken = OutSession.Token;
     // Parse the request to extract headers
     TArray<FString> Lines;
     Request.ParseIntoArray(Lines, TEXT("\r\n"));
@@ -168,7 +414,8 @@ bool FWsServer::PerformHandshake(FSocket* Socket, FString& OutToken)
 
     FString Path = RequestParts[1];
 
-    // Extract token from query param
+    // Extract token and resume point from query params
+    OutSession.ResumeAfterSeq = MAX_uint64;
     int32 QueryIndex;
     if (Path.FindChar('?', QueryIndex))
     {
@@ -180,19 +427,43 @@ bool FWsServer::PerformHandshake(FSocket* Socket, FString& OutToken)
             if (Param.StartsWith(TEXT("token=")))
             {
                 OutToken = Param.Mid(6);
-                break;
+            }
+            else if (Param.StartsWith(TEXT("since=")) && Param.Mid(6).IsNumeric())
+            {
+                OutSession.ResumeAfterSeq = FCString::Strtoui64(*Param.Mid(6), nullptr, 10);
             }
         }
     }
 
-    // Extract Sec-WebSocket-Key
+    // Validate token before upgrading
+    if (Auth && !Auth->ValidateToken(OutToken))
+    {
+        UE_LOG(LogWsServer, Warning, TEXT("WebSocket connection rejected: invalid token"));
+        return false;
+    }
+
+    // Extract Sec-WebSocket-Key, extension offers and subprotocols (these two may repeat)
     FString WebSocketKey;
+    FString ExtensionOffers;
+    TArray<FString> Subprotocols;
     for (const FString& Line : Lines)
     {
         if (Line.StartsWith(TEXT("Sec-WebSocket-Key:"), ESearchCase::IgnoreCase))
         {
             WebSocketKey = Line.Mid(18).TrimStartAndEnd();
-            break;
+        }
+        else if (Line.StartsWith(TEXT("Sec-WebSocket-Extensions:"), ESearchCase::IgnoreCase))
+        {
+            ExtensionOffers += (ExtensionOffers.IsEmpty() ? TEXT("") : TEXT(",")) + Line.Mid(25);
+        }
+        else if (Line.StartsWith(TEXT("Sec-WebSocket-Protocol:"), ESearchCase::IgnoreCase))
+        {
+            TArray<FString> Offered;
+            Line.Mid(23).ParseIntoArray(Offered, TEXT(","));
+            for (const FString& Name : Offered)
+            {
+                Subprotocols.Add(Name.TrimStartAndEnd());
+            }
         }
     }
 
@@ -204,23 +475,39 @@ bool FWsServer::PerformHandshake(FSocket* Socket, FString& OutToken)
     // Compute accept key
     FString AcceptKey = ComputeAcceptKey(WebSocketKey);
 
-    // Send the upgrade response
-    FString Response = FString::Printf(
+    FString NegotiatedHeaders;
+    FString AcceptedExtension;
+    OutSession.Deflate = FWsDeflateParams();
+    if (bDeflateEnabled && !ExtensionOffers.IsEmpty() &&
+        FWsDeflateParams::Negotiate(ExtensionOffers, DeflateWindowBits, OutSession.Deflate, AcceptedExtension))
+    {
+        NegotiatedHeaders = FString::Printf(TEXT("Sec-WebSocket-Extensions: %s\r\n"), *AcceptedExtension);
+    }
+
+    // The client lists subprotocols in order of preference; take the first we speak
+    OutSession.Encoding = EWsEncoding::Json;
+    for (const FString& Name : Subprotocols)
+    {
+        if (Name == JsonSubprotocol || (bBinaryEvents && Name == CborSubprotocol))
+        {
+            OutSession.Encoding = Name == CborSubprotocol ? EWsEncoding::Cbor : EWsEncoding::Json;
+            NegotiatedHeaders += FString::Printf(TEXT("Sec-WebSocket-Protocol: %s\r\n"), *Name);
+            break;
+        }
+    }
+
+    // Build the upgrade response
+    OutResponse = FString::Printf(
         TEXT("HTTP/1.1 101 Switching Protocols\r\n"
              "Upgrade: websocket\r\n"
              "Connection: Upgrade\r\n"
              "Sec-WebSocket-Accept: %s\r\n"
+             "%s"
              "Access-Control-Allow-Origin: *\r\n"
              "\r\n"),
-        *AcceptKey
+        *AcceptKey, *NegotiatedHeaders
     );
 
-    FTCHARToUTF8 Utf8Response(*Response);
-    int32 BytesSent = 0;
-    Socket->Send(reinterpret_cast<const uint8*>(Utf8Response.Get()), Utf8Response.Length(), BytesSent);
-
-    Socket->SetNonBlocking(true);
-
     return true;
 }
 
@@ -1,16 +1,34 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "Common/TcpListener.h"
 #include "Sockets.h"
 #include "Auth/TokenAuth.h"
 #include "WsConnection.h"
+#include "WsSubscriptionIndex.h"
 #include "Models/ControlModels.h"
+#include "Events/ControlEventJournal.h"
+
+class FSocketReactor;
+class IReactorConnection;
+
+/** An immutable list of the connected clients; replaced, never modified, once published */
+using FWsConnectionList = TArray<TSharedPtr<FWsConnection>>;
 
 /**
  * WebSocket server for real-time command status events.
- * Accepts connections on a separate port (default 9091), performs
- * RFC 6455 handshake, and pushes COMMAND_STATUS events to all clients.
+ * Accepts connections on a separate port (default 9091) through the shared
+ * FSocketReactor, which performs the RFC 6455 handshake and all later reads
+ * and writes on its network thread. Journaled events (COMMAND_STATUS,
+ * COMMAND_BATCH) are queued from the publishing thread to every client that
+ * has not subscribed, and to subscribed clients only when a filter matches.
+ * Each event carries its journal number as "seq"; a client reconnecting
+ * with ?since=<seq> is first sent the events it missed, or a RESYNC event
+ * when they are no longer retained. Clients may also submit commands on
+ * the socket; each client always hears about the commands it submitted.
+ *
+ * The client list is copy-on-write: connects and disconnects publish a new
+ * list, and broadcasters iterate whichever list was current when they
+ * started, so they never wait on each other or on the reactor.
  */
 class FICSITCONTROL_API FWsServer
 {
@@ -18,35 +36,165 @@ public:
     FWsServer();
     ~FWsServer();
 
-    /** Start the WebSocket server on the given port */
-    bool Start(int32 Port, FTokenAuth* InAuth);
+    /** Start the WebSocket server on the given port via the reactor */
+    bool Start(int32 Port, FTokenAuth* InAuth, TSharedRef<FSocketReactor> InReactor);
+
+    /** Also accept clients on a Unix domain socket at Path (call after Start) */
+    bool StartLocal(const FString& Path, int32 FileMode);
 
     /** Stop and close all connections */
     void Stop();
 
-    /** Broadcast a command status event to all connected clients */
-    void BroadcastCommandStatus(const FControlCommand& Command);
+    /** Delegate for commands submitted over WebSocket — set by ControlSubsystem */
+    DECLARE_DELEGATE_RetVal_OneParam(FControlCommand, FOnCommandReceived, const FControlCommandRequest& /* Request */);
+    FOnCommandReceived OnCommandReceived;
+
+    /** Route a command a client submitted (reactor thread) */
+    FControlCommand SubmitCommand(const FControlCommandRequest& Request);
+
+    /** Queue a journaled event to every client that wants it */
+    void BroadcastEvent(const FControlEvent& Event);
+
+    /** Wake the reactor so frames queued from other threads are flushed promptly */
+    void WakeReactor();
+
+    /** Journal that new connections attach to for replay (set before Start) */
+    void SetEventJournal(TSharedPtr<FControlEventJournal> InJournal) { EventJournal = InJournal; }
+
+    /** Cap on connected clients; further sockets are closed on accept */
+    void SetMaxConnections(int32 InMaxConnections) { MaxConnections = InMaxConnections; }
+
+    /**
+     * permessage-deflate (RFC 7692): offered by clients, accepted when enabled.
+     * WindowBits (9..15) caps the compressor's window; messages with fewer
+     * than Threshold payload bytes go out uncompressed.
+     */
+    void SetDeflate(bool bInEnabled, int32 InWindowBits, int32 InThreshold)
+    {
+        bDeflateEnabled = bInEnabled;
+        DeflateWindowBits = InWindowBits;
+        DeflateThreshold = InThreshold;
+    }
+
+    /**
+     * Offer the binary subprotocol (CBOR events). The journal must encode
+     * CBOR for it; without, binary clients are sent JSON text frames.
+     */
+    void SetBinaryEvents(bool bInEnabled) { bBinaryEvents = bInEnabled; }
+
+    /**
+     * Ping every client each Interval seconds (0 disables) and drop those that
+     * leave MaxMissed pings in a row unanswered. Apply before Start.
+     */
+    void SetHeartbeat(float InInterval, int32 InMaxMissed)
+    {
+        PingInterval = InInterval;
+        MaxMissedPongs = InMaxMissed;
+    }
+
+    /** High-water mark for each client's send queue; clients past it are disconnected */
+    void SetMaxQueuedBytes(int64 InMaxQueuedBytes) { MaxQueuedBytes = InMaxQueuedBytes; }
+
+    /** Largest upgrade request accepted, and the time a client has to send it */
+    void SetHandshakeLimits(int32 InMaxBytes, float InTimeout)
+    {
+        MaxHandshakeBytes = InMaxBytes;
+        HandshakeTimeout = InTimeout;
+    }
+    int32 GetMaxHandshakeBytes() const { return MaxHandshakeBytes; }
+    float GetHandshakeTimeout() const { return HandshakeTimeout; }
+
+    /** Handshake bookkeeping (reactor thread) */
+    void OnHandshakeStarted() { ++NumHandshakes; }
+    void OnHandshakeEnded() { --NumHandshakes; }
+    void OnHandshakeTimedOut() { ++HandshakeTimeouts; }
 
-    /** Tick — process incoming frames, remove dead connections */
-    void Tick();
+    /** Connection counts and timeouts for /control/v1/stats */
+    TSharedRef<FJsonObject> GetStatsJson();
 
-    /** Get the number of connected clients */
-    int32 GetConnectionCount() const { return Connections.Num(); }
+    /** Get the number of connected clients (any thread) */
+    int32 GetConnectionCount() const { return NumConnections.Load(); }
+
+    /**
+     * Validate an upgrade request and build the 101 response, accepting a
+     * permessage-deflate offer if compression is enabled and choosing the
+     * event encoding from the offered subprotocols.
+     * Returns false if the request is not a valid, authorized upgrade.
+     */
+    bool BuildHandshakeResponse(const FString& Request, FWsSessionOptions& OutSession, FString& OutResponse);
+
+    /** Adopt a socket whose handshake completed; the reactor services it from now on */
+    TSharedRef<FWsConnection> AddConnection(FSocket* Socket, const FWsSessionOptions& Session);
+
+    /** Forget a connection the reactor closed (reactor thread) */
+    void RemoveConnection(const FWsConnection* Connection);
+
+    /** Subscription routing, maintained by connections as clients (un)subscribe */
+    FWsSubscriptionIndex& GetSubscriptions() { return Subscriptions; }
+
+    /** Count a client disconnected for falling behind (reactor thread) */
+    void OnSlowClientEvicted() { ++SlowClientEvictions; }
+
+    /** Count a client dropped for not answering pings (reactor thread) */
+    void OnDeadPeerDropped() { ++DeadPeersDropped; }
 
 private:
-    /** Called when a new TCP connection arrives */
-    bool HandleConnection(FSocket* ClientSocket, const FIPv4Endpoint& Endpoint);
+    /** Called by the reactor when a new TCP connection arrives */
+    TSharedPtr<IReactorConnection> HandleConnection(FSocket* ClientSocket);
+
+    /**
+     * Queue the events a resuming client missed, before any live event.
+     * Sends RESYNC instead if some were dropped (bGap) or the backlog would
+     * take more than half the client's send queue.
+     */
+    void ReplayEvents(FWsConnection& Connection, uint64 AfterSeq, uint64 LastSeq,
+        const TArray<TSharedRef<const FControlEvent>>& Missed, bool bGap);
 
-    /** Perform the WebSocket upgrade handshake */
-    bool PerformHandshake(FSocket* Socket, FString& OutToken);
+    /** The current connection list; stays valid, and unchanged, for as long as it is held */
+    TSharedRef<const FWsConnectionList> SnapshotConnections() const;
+
+    /** Publish a copy of the connection list with Edit applied (writers only) */
+    void UpdateConnections(TFunctionRef<void(FWsConnectionList&)> Edit);
 
     /** Compute Sec-WebSocket-Accept from client key */
     FString ComputeAcceptKey(const FString& ClientKey);
 
-    TUniquePtr<FTcpListener> Listener;
-    TArray<TSharedPtr<FWsConnection>> Connections;
+    TSharedPtr<FSocketReactor> Reactor;
+    int32 ListenerId = INDEX_NONE;
+    int32 LocalListenerId = INDEX_NONE;
+    TSharedRef<const FWsConnectionList> Connections;
+    TAtomic<int32> NumConnections { 0 };
+    FWsSubscriptionIndex Subscriptions;
     FTokenAuth* Auth = nullptr;
-    bool bRunning = false;
+    TAtomic<bool> bRunning { false };
+    int32 MaxConnections = 128;
+    int32 MaxHandshakeBytes = 8192;
+    float HandshakeTimeout = 5.0f;
+
+    /** Sockets still in the upgrade handshake; they count against MaxConnections */
+    TAtomic<int32> NumHandshakes { 0 };
+    TAtomic<int64> HandshakeTimeouts { 0 };
+
+    int64 MaxQueuedBytes = 1024 * 1024;
+
+    bool bBinaryEvents = true;
+    bool bDeflateEnabled = true;
+    int32 DeflateWindowBits = 15;
+    int32 DeflateThreshold = 256;
+    TAtomic<int64> SlowClientEvictions { 0 };
 
+    float PingInterval = 20.0f;
+    int32 MaxMissedPongs = 2;
+    TAtomic<int64> DeadPeersDropped { 0 };
+
+    TSharedPtr<FControlEventJournal> EventJournal;
+    TAtomic<int64> ReplayedEvents { 0 };
+    TAtomic<int64> Resyncs { 0 };
+    TAtomic<int64> CommandsReceived { 0 };
+
+    /** Serializes the writers that build and publish a new connection list */
     FCriticalSection ConnectionsMutex;
+
+    /** Guards only the Connections pointer: readers share it to take a reference */
+    mutable FRWLock ConnectionsPointerLock;
 };
@@ -0,0 +1,193 @@
+#include "WsSubscriptionIndex.h"
+
+bool FWsSubscriptionFilter::Matches(const FControlEventTopic& Topic) const
+{
+    return (CommandIds.Num() == 0 || CommandIds.Contains(Topic.CommandId))
+        && (BuildingIds.Num() == 0 || BuildingIds.Contains(Topic.BuildingId))
+        && (Issuers.Num() == 0 || Issuers.Contains(Topic.Issuer))
+        && (CommandTypes.Num() == 0 || CommandTypes.Contains(Topic.CommandType));
+}
+
+int32 FWsSubscriptionIndex::Add(const FWsConnection* Connection, const FString& Id, FWsSubscriptionFilter&& Filter)
+{
+    FSubscriptionRef Subscription = MakeShared<const FSubscription>(FSubscription{ Connection, Id, MoveTemp(Filter) });
+
+    FScopeLock Lock(&Mutex);
+
+    TArray<FSubscriptionRef>& Owned = ByConnection.FindOrAdd(Connection);
+    const int32 Existing = Owned.IndexOfByPredicate([&Id](const FSubscriptionRef& Sub) { return Sub->Id == Id; });
+    if (Existing != INDEX_NONE)
+    {
+        Unlink(Owned[Existing]);
+        Owned[Existing] = Subscription;
+    }
+    else
+    {
+        Owned.Add(Subscription);
+        ++NumSubscriptions;
+    }
+
+    Link(Subscription);
+    return Owned.Num();
+}
+
+int32 FWsSubscriptionIndex::Remove(const FWsConnection* Connection, const FString& Id)
+{
+    FScopeLock Lock(&Mutex);
+
+    TArray<FSubscriptionRef>* Owned = ByConnection.Find(Connection);
+    if (!Owned) return INDEX_NONE;
+
+    const int32 Existing = Owned->IndexOfByPredicate([&Id](const FSubscriptionRef& Sub) { return Sub->Id == Id; });
+    if (Existing == INDEX_NONE) return INDEX_NONE;
+
+    Unlink((*Owned)[Existing]);
+    Owned->RemoveAtSwap(Existing);
+    --NumSubscriptions;
+
+    const int32 Remaining = Owned->Num();
+    if (Remaining == 0)
+    {
+        ByConnection.Remove(Connection);
+    }
+    return Remaining;
+}
+
+void FWsSubscriptionIndex::RemoveAll(const FWsConnection* Connection)
+{
+    FScopeLock Lock(&Mutex);
+
+    TArray<FSubscriptionRef> Owned;
+    if (!ByConnection.RemoveAndCopyValue(Connection, Owned)) return;
+
+    for (const FSubscriptionRef& Subscription : Owned)
+    {
+        Unlink(Subscription);
+    }
+    NumSubscriptions -= Owned.Num();
+}
+
+void FWsSubscriptionIndex::Match(TConstArrayView<FControlEventTopic> Topics,
+    TMap<const FWsConnection*, TBitArray<>>& OutMatched) const
+{
+    FScopeLock Lock(&Mutex);
+
+    for (int32 i = 0; i < Topics.Num(); ++i)
+    {
+        const FControlEventTopic& Topic = Topics[i];
+
+        // A subscription can only match from the bucket of its own key value
+        const TPair<const TMap<FString, TArray<FSubscriptionRef>>*, const FString*> Candidates[] = {
+            { &ByCommandId, &Topic.CommandId },
+            { &ByBuildingId, &Topic.BuildingId },
+            { &ByIssuer, &Topic.Issuer },
+            { &ByCommandType, &Topic.CommandType }
+        };
+        for (const auto& Candidate : Candidates)
+        {
+            if (Candidate.Value->IsEmpty()) continue;
+            if (const TArray<FSubscriptionRef>* Bucket = Candidate.Key->Find(*Candidate.Value))
+            {
+                MatchList(*Bucket, Topics, i, OutMatched);
+            }
+        }
+
+        MatchList(MatchAll, Topics, i, OutMatched);
+    }
+}
+
+int32 FWsSubscriptionIndex::Num() const
+{
+    FScopeLock Lock(&Mutex);
+    return NumSubscriptions;
+}
+
+FWsSubscriptionIndex::EIndexKey FWsSubscriptionIndex::ChooseKey(const FWsSubscriptionFilter& Filter)
+{
+    // Command IDs are unique and buildings are many; issuers and types are few
+    if (Filter.CommandIds.Num() > 0) return EIndexKey::CommandId;
+    if (Filter.BuildingIds.Num() > 0) return EIndexKey::BuildingId;
+    if (Filter.Issuers.Num() > 0) return EIndexKey::Issuer;
+    if (Filter.CommandTypes.Num() > 0) return EIndexKey::CommandType;
+    return EIndexKey::All;
+}
+
+TMap<FString, TArray<FWsSubscriptionIndex::FSubscriptionRef>>* FWsSubscriptionIndex::GetBuckets(EIndexKey Key)
+{
+    switch (Key)
+    {
+    case EIndexKey::CommandId:   return &ByCommandId;
+    case EIndexKey::BuildingId:  return &ByBuildingId;
+    case EIndexKey::Issuer:      return &ByIssuer;
+    case EIndexKey::CommandType: return &ByCommandType;
+    default:                     return nullptr;
+    }
+}
+
+const TSet<FString>* FWsSubscriptionIndex::GetKeyValues(const FWsSubscriptionFilter& Filter, EIndexKey Key)
+{
+    switch (Key)
+    {
+    case EIndexKey::CommandId:   return &Filter.CommandIds;
+    case EIndexKey::BuildingId:  return &Filter.BuildingIds;
+    case EIndexKey::Issuer:      return &Filter.Issuers;
+    case EIndexKey::CommandType: return &Filter.CommandTypes;
+    default:                     return nullptr;
+    }
+}
+
+void FWsSubscriptionIndex::Link(const FSubscriptionRef& Subscription)
+{
+    const EIndexKey Key = ChooseKey(Subscription->Filter);
+    TMap<FString, TArray<FSubscriptionRef>>* Buckets = GetBuckets(Key);
+    if (!Buckets)
+    {
+        MatchAll.Add(Subscription);
+        return;
+    }
+
+    for (const FString& Value : *GetKeyValues(Subscription->Filter, Key))
+    {
+        Buckets->FindOrAdd(Value).Add(Subscription);
+    }
+}
+
+void FWsSubscriptionIndex::Unlink(const FSubscriptionRef& Subscription)
+{
+    const EIndexKey Key = ChooseKey(Subscription->Filter);
+    TMap<FString, TArray<FSubscriptionRef>>* Buckets = GetBuckets(Key);
+    if (!Buckets)
+    {
+        MatchAll.RemoveSingleSwap(Subscription);
+        return;
+    }
+
+    for (const FString& Value : *GetKeyValues(Subscription->Filter, Key))
+    {
+        if (TArray<FSubscriptionRef>* Bucket = Buckets->Find(Value))
+        {
+            Bucket->RemoveSingleSwap(Subscription);
+            if (Bucket->Num() == 0)
+            {
+                Buckets->Remove(Value);
+            }
+        }
+    }
+}
+
+void FWsSubscriptionIndex::MatchList(const TArray<FSubscriptionRef>& Subscriptions,
+    TConstArrayView<FControlEventTopic> Topics, int32 TopicIndex, TMap<const FWsConnection*, TBitArray<>>& OutMatched)
+{
+    for (const FSubscriptionRef& Subscription : Subscriptions)
+    {
+        if (Subscription->Filter.Matches(Topics[TopicIndex]))
+        {
+            TBitArray<>* Wanted = OutMatched.Find(Subscription->Connection);
+            if (!Wanted)
+            {
+                Wanted = &OutMatched.Add(Subscription->Connection, TBitArray<>(false, Topics.Num()));
+            }
+            (*Wanted)[TopicIndex] = true;
+        }
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Events/ControlEventJournal.h"
+
+class FWsConnection;
+
+/**
+ * What a subscription wants to hear about. Each set left empty matches
+ * anything; a topic matches when it is in every non-empty set.
+ */
+struct FWsSubscriptionFilter
+{
+    TSet<FString> CommandTypes;
+    TSet<FString> CommandIds;
+    TSet<FString> Issuers;
+    TSet<FString> BuildingIds;
+
+    bool Matches(const FControlEventTopic& Topic) const;
+
+    /** Total number of values across all sets */
+    int32 NumValues() const
+    {
+        return CommandTypes.Num() + CommandIds.Num() + Issuers.Num() + BuildingIds.Num();
+    }
+};
+
+/**
+ * Routes events to the WebSocket clients that subscribed to them.
+ * Each subscription is filed under the values of its most selective set
+ * (command ID, then building, issuer, type), or in a catch-all list when
+ * it has none, so matching a topic only looks at the few subscriptions that
+ * could possibly want it instead of testing every client. Thread-safe: the
+ * reactor adds and removes subscriptions while publishers match.
+ */
+class FWsSubscriptionIndex
+{
+public:
+    /**
+     * Add or replace the subscription Id of Connection.
+     * Returns the number of subscriptions the connection now holds.
+     */
+    int32 Add(const FWsConnection* Connection, const FString& Id, FWsSubscriptionFilter&& Filter);
+
+    /** Drop one subscription. Returns the number left, or INDEX_NONE if Id was unknown. */
+    int32 Remove(const FWsConnection* Connection, const FString& Id);
+
+    /** Drop every subscription of a closing connection */
+    void RemoveAll(const FWsConnection* Connection);
+
+    /**
+     * Find the connections with a subscription matching any of Topics. Each
+     * gets a bit per topic, set for the topics it wants.
+     */
+    void Match(TConstArrayView<FControlEventTopic> Topics, TMap<const FWsConnection*, TBitArray<>>& OutMatched) const;
+
+    /** Total subscriptions, across all connections */
+    int32 Num() const;
+
+private:
+    struct FSubscription
+    {
+        const FWsConnection* Connection;
+        FString Id;
+        FWsSubscriptionFilter Filter;
+    };
+    using FSubscriptionRef = TSharedRef<const FSubscription>;
+
+    /** Which bucket map a subscription is filed in */
+    enum class EIndexKey : uint8
+    {
+        CommandId,
+        BuildingId,
+        Issuer,
+        CommandType,
+        All
+    };
+
+    static EIndexKey ChooseKey(const FWsSubscriptionFilter& Filter);
+
+    /** The bucket map for Key, or nullptr for the catch-all list */
+    TMap<FString, TArray<FSubscriptionRef>>* GetBuckets(EIndexKey Key);
+
+    /** The values a subscription is filed under for Key */
+    static const TSet<FString>* GetKeyValues(const FWsSubscriptionFilter& Filter, EIndexKey Key);
+
+    void Link(const FSubscriptionRef& Subscription);
+    void Unlink(const FSubscriptionRef& Subscription);
+
+    /** Mark topic TopicIndex for every connection in a list whose filter accepts it */
+    static void MatchList(const TArray<FSubscriptionRef>& Subscriptions, TConstArrayView<FControlEventTopic> Topics,
+        int32 TopicIndex, TMap<const FWsConnection*, TBitArray<>>& OutMatched);
+
+    TMap<FString, TArray<FSubscriptionRef>> ByCommandId;
+    TMap<FString, TArray<FSubscriptionRef>> ByBuildingId;
+    TMap<FString, TArray<FSubscriptionRef>> ByIssuer;
+    TMap<FString, TArray<FSubscriptionRef>> ByCommandType;
+    TArray<FSubscriptionRef> MatchAll;
+
+    /** Every subscription of each connection, for replacement and cleanup */
+    TMap<const FWsConnection*, TArray<FSubscriptionRef>> ByConnection;
+
+    int32 NumSubscriptions = 0;
+
+    mutable FCriticalSection Mutex;
+};
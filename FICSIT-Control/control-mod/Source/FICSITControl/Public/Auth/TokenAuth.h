@@ -44,6 +44,13 @@ public:
         return ProvidedToken == Token;
     }
 
+    /**
+     * Non-secret stand-in for a token, safe to store and to share between
+     * clients: the first 16 hex digits of the SHA-1 of its UTF-8 bytes.
+     * Empty for an empty token.
+     */
+    static FString Fingerprint(const FString& InToken);
+
 private:
     FString Token;
 };
@@ -11,8 +11,48 @@ struct FICSITCONTROL_API FControlConfig
 {
     int32 HttpPort = 9090;
     int32 WsPort = 9091;
+    float KeepAliveTimeout = 5.0f;
+    int32 MaxKeepAliveRequests = 100;
+    int32 WorkerThreads = 2;
+    float RequestTimeout = 10.0f;
+    float WriteTimeout = 30.0f;
+    /** Unix domain socket paths; empty disables the local listener */
+    FString HttpSocketPath;
+    FString WsSocketPath;
+    /** Permission bits for the socket files (octal in the ini) */
+    int32 SocketFileMode = 0660;
+    /** permessage-deflate for WebSocket clients that offer it */
+    bool bWsDeflate = true;
+    int32 WsDeflateWindowBits = 15;
+    int32 WsDeflateThreshold = 256;
+    /** Offer CBOR events to WebSocket clients that ask for the binary subprotocol */
+    bool bWsBinaryEvents = true;
+    /** Seconds between pings to WebSocket clients (0 = none), and unanswered pings before one is dropped */
+    float WsPingInterval = 20.0f;
+    int32 WsMaxMissedPongs = 2;
+    /** Seconds status changes are gathered before being sent as one event (0 = every tick) */
+    float EventFlushInterval = 0.05f;
+    /** Most commands reported in one coalesced event */
+    int32 EventBatchSize = 256;
+    /** Events retained for replay to reconnecting streams */
+    int32 EventHistorySize = 1024;
     FString AuthToken;
     int32 RateLimit = 5;
+    /** Commands per second accepted through batches; at least MaxBatchSize */
+    int32 BatchRateLimit = 500;
+    int32 MaxHeaderBytes = 16 * 1024;
+    int32 MaxRequestBodyBytes = 8 * 1024 * 1024;
+    /** At most MaxPendingCommands / 4, so a full batch fits in the bulk half with room to spare */
+    int32 MaxBatchSize = 250;
+    int32 MaxConnections = 128;
+    int32 MaxTotalConnections = 256;
+    int32 MaxInFlightRequests = 64;
+    int32 MaxPendingCommands = 1000;
+    /** How long, and how many, settled commands are kept for lookups and idempotency */
+    float CommandRetentionSeconds = 3600.0f;
+    int32 MaxRetainedCommands = 10000;
+    int32 WsMaxQueuedBytes = 1024 * 1024;
+    int32 SseMaxQueuedBytes = 1024 * 1024;
 
     bool bResetFuse = true;
     bool bToggleBuilding = true;
@@ -7,6 +7,9 @@
 class FControlHttpServer;
 class FCommandRouter;
 class FWsServer;
+class FSocketReactor;
+class FControlEventJournal;
+class FControlEventCoalescer;
 
 UCLASS()
 class FICSITCONTROL_API AControlSubsystem : public AModSubsystem
@@ -24,10 +27,12 @@ public:
 
     virtual void BeginPlay() override;
     virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
-    virtual void Tick(float DeltaTime) override;
 
 private:
+    TSharedPtr<FSocketReactor> Reactor;
     TSharedPtr<FControlHttpServer> HttpServer;
     TSharedPtr<FCommandRouter> CommandRouter;
     TSharedPtr<FWsServer> WsServer;
+    TSharedPtr<FControlEventJournal> EventJournal;
+    TSharedPtr<FControlEventCoalescer> EventCoalescer;
 };
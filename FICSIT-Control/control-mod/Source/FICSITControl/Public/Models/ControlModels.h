@@ -15,6 +15,9 @@ struct FControlCapabilities
     bool bSetRecipe = true;
     bool bSetOverclock = true;
     int32 CommandsPerSecond = 5;
+    /** Budget for commands submitted in batches, separate from CommandsPerSecond */
+    int32 BatchCommandsPerSecond = 500;
+    int32 MaxBatchSize = 250;
 
     TSharedRef<FJsonObject> ToJson() const
     {
@@ -31,6 +34,8 @@ struct FControlCapabilities
 
         auto Limits = MakeShared<FJsonObject>();
         Limits->SetNumberField(TEXT("commandsPerSecond"), CommandsPerSecond);
+        Limits->SetNumberField(TEXT("batchCommandsPerSecond"), BatchCommandsPerSecond);
+        Limits->SetNumberField(TEXT("maxBatchSize"), MaxBatchSize);
         Root->SetObjectField(TEXT("limits"), Limits);
 
         return Root;
@@ -58,6 +63,21 @@ inline FString CommandStatusToString(EControlCommandStatus Status)
     }
 }
 
+/** Why a submission was turned away before a command was created */
+enum class EControlRejection : uint8
+{
+    None,
+    RateLimited,
+    /** A queue is full; the client should retry later (HTTP 503) */
+    Overloaded
+};
+
+/** True once a command can no longer change status */
+inline bool IsTerminalStatus(EControlCommandStatus Status)
+{
+    return Status == EControlCommandStatus::Succeeded || Status == EControlCommandStatus::Failed;
+}
+
 /** A command received from the web app */
 struct FControlCommand
 {
@@ -65,9 +85,18 @@ struct FControlCommand
     FString IdempotencyKey;
     FString Type;
     TSharedPtr<FJsonObject> Payload;
+    /** Fingerprint of the token the command was submitted with; used for event routing, never serialized */
+    FString Issuer;
+    /** Correlation ID chosen by the WebSocket client that submitted it; echoed in events */
+    FString RequestId;
+    /** WebSocket connection that submitted it (0 for HTTP); used for event routing, never serialized */
+    uint64 StreamId = 0;
+    /** FPlatformTime seconds when the router created it; drives retention, never serialized */
+    double CreatedTime = 0.0;
     EControlCommandStatus Status = EControlCommandStatus::Queued;
     TSharedPtr<FJsonValue> Result;
     FString Error;
+    EControlRejection Rejection = EControlRejection::None;
 
     TSharedRef<FJsonObject> ToResponseJson() const
     {
@@ -101,6 +130,10 @@ struct FControlCommand
         auto Root = MakeShared<FJsonObject>();
         Root->SetStringField(TEXT("event"), TEXT("COMMAND_STATUS"));
         Root->SetStringField(TEXT("commandId"), CommandId);
+        if (!RequestId.IsEmpty())
+        {
+            Root->SetStringField(TEXT("requestId"), RequestId);
+        }
         Root->SetStringField(TEXT("status"), CommandStatusToString(Status));
 
         if (Result.IsValid())
@@ -125,6 +158,18 @@ struct FControlCommand
     }
 };
 
+/** One entry of a batch submission, before a command is created for it */
+struct FControlCommandRequest
+{
+    FString IdempotencyKey;
+    FString Type;
+    TSharedPtr<FJsonObject> Payload;
+    /** Fingerprint of the submitting token (FTokenAuth::Fingerprint) */
+    FString Issuer;
+    FString RequestId;
+    uint64 StreamId = 0;
+};
+
 /** Serialize a JSON object to a compact string */
 inline FString JsonToString(const TSharedRef<FJsonObject>& JsonObj)
 {
@@ -22,11 +22,15 @@ interface StoredCommand {
   status: "QUEUED" | "RUNNING" | "SUCCEEDED" | "FAILED";
   result: unknown | null;
   error: string | null;
+  /** Set for commands submitted over the WebSocket; echoed in their events */
+  requestId?: string;
 }
 
 const commands = new Map<string, StoredCommand>();
 const idempotencyIndex = new Map<string, string>(); // idempotencyKey -> commandId
 const wsClients = new Set<WebSocket>();
+const sseClients = new Set<ServerResponse>();
+let lastEventId = 0;
 
 const CAPABILITIES = {
   version: "1.0.0",
@@ -39,6 +43,8 @@ const CAPABILITIES = {
   },
   limits: {
     commandsPerSecond: 5,
+    batchCommandsPerSecond: 500,
+    maxBatchSize: 250,
   },
 };
 
@@ -49,12 +55,17 @@ function generateId(): string {
 }
 
 function broadcast(msg: object) {
-  const json = JSON.stringify(msg);
+  const seq = ++lastEventId;
+  const json = JSON.stringify({ ...msg, seq });
   for (const ws of wsClients) {
     if (ws.readyState === WebSocket.OPEN) {
       ws.send(json);
     }
   }
+  const frame = `id: ${seq}\ndata: ${json}\n\n`;
+  for (const res of sseClients) {
+    res.write(frame);
+  }
 }
 
 function readBody(req: IncomingMessage): Promise<string> {
@@ -89,7 +100,14 @@ function simulateExecution(cmd: StoredCommand) {
   // QUEUED -> RUNNING after 200ms
   setTimeout(() => {
     cmd.status = "RUNNING";
-    broadcast({ event: "COMMAND_STATUS", commandId: cmd.commandId, status: "RUNNING", result: null, error: null });
+    broadcast({
+      event: "COMMAND_STATUS",
+      commandId: cmd.commandId,
+      requestId: cmd.requestId,
+      status: "RUNNING",
+      result: null,
+      error: null,
+    });
 
     // RUNNING -> SUCCEEDED after 300ms
     setTimeout(() => {
@@ -98,6 +116,7 @@ function simulateExecution(cmd: StoredCommand) {
       broadcast({
         event: "COMMAND_STATUS",
         commandId: cmd.commandId,
+        requestId: cmd.requestId,
         status: "SUCCEEDED",
         result: cmd.result,
         error: null,
@@ -170,6 +189,87 @@ const server = createServer(async (req, res) => {
     return;
   }
 
+  // GET /control/v1/events (auth via header or ?token=; no replay in the mock)
+  if (req.method === "GET" && url.pathname === "/control/v1/events") {
+    if (!checkAuth(req) && url.searchParams.get("token") !== TOKEN) {
+      json(res, 401, { error: "Unauthorized" });
+      return;
+    }
+    res.writeHead(200, {
+      "Content-Type": "text/event-stream",
+      "Cache-Control": "no-cache",
+      "Access-Control-Allow-Origin": "*",
+    });
+    res.write("retry: 2000\n\n");
+    sseClients.add(res);
+    req.on("close", () => sseClients.delete(res));
+    return;
+  }
+
+  // POST /control/v1/commands/batch (auth required)
+  if (req.method === "POST" && url.pathname === "/control/v1/commands/batch") {
+    if (!checkAuth(req)) {
+      json(res, 401, { error: "Unauthorized" });
+      return;
+    }
+
+    let parsed: { commands?: { idempotencyKey?: string; type?: string; payload?: unknown }[] };
+    try {
+      parsed = JSON.parse(await readBody(req));
+    } catch {
+      json(res, 400, { error: "Invalid JSON" });
+      return;
+    }
+
+    if (!Array.isArray(parsed.commands) || parsed.commands.length === 0) {
+      json(res, 400, { error: "Missing required field: commands" });
+      return;
+    }
+
+    const batch: StoredCommand[] = [];
+    const responses = parsed.commands.map((item) => {
+      const existingId = item.idempotencyKey ? idempotencyIndex.get(item.idempotencyKey) : undefined;
+      if (existingId) {
+        const existing = commands.get(existingId)!;
+        return { commandId: existing.commandId, status: existing.status };
+      }
+      const cmd: StoredCommand = {
+        commandId: generateId(),
+        idempotencyKey: item.idempotencyKey ?? generateId(),
+        type: item.type ?? "",
+        payload: item.payload ?? null,
+        status: "QUEUED",
+        result: null,
+        error: null,
+      };
+      commands.set(cmd.commandId, cmd);
+      idempotencyIndex.set(cmd.idempotencyKey, cmd.commandId);
+      batch.push(cmd);
+      return { commandId: cmd.commandId, status: "QUEUED" };
+    });
+
+    json(res, 202, { commands: responses });
+
+    // The mod applies a whole batch in one game tick and reports it as one event
+    setTimeout(() => {
+      for (const cmd of batch) {
+        cmd.status = "SUCCEEDED";
+        cmd.result = { message: `${cmd.type} executed successfully` };
+      }
+      broadcast({
+        event: "COMMAND_BATCH",
+        commands: batch.map((cmd) => ({
+          event: "COMMAND_STATUS",
+          commandId: cmd.commandId,
+          status: cmd.status,
+          result: cmd.result,
+          error: null,
+        })),
+      });
+    }, 200);
+    return;
+  }
+
   // GET /control/v1/commands/:id (auth required)
   const cmdMatch = url.pathname.match(/^\/control\/v1\/commands\/(.+)$/);
   if (req.method === "GET" && cmdMatch) {
@@ -184,6 +284,13 @@ const server = createServer(async (req, res) => {
       return;
     }
 
+    // ?wait=<seconds> long-polls until the command settles
+    const wait = Math.min(Number(url.searchParams.get("wait") ?? 0) || 0, 30);
+    const deadline = Date.now() + wait * 1000;
+    while (cmd.status !== "SUCCEEDED" && cmd.status !== "FAILED" && Date.now() < deadline) {
+      await new Promise((resolve) => setTimeout(resolve, 50));
+    }
+
     json(res, 200, {
       commandId: cmd.commandId,
       status: cmd.status,
@@ -209,9 +316,58 @@ wss.on("connection", (ws, req) => {
     return;
   }
 
+  // The mock keeps no history: a client that missed events is told to refetch
+  const since = url.searchParams.get("since");
+  if (since !== null && Number(since) < lastEventId) {
+    ws.send(JSON.stringify({ event: "RESYNC", since: Number(since), seq: lastEventId }));
+  }
+
   wsClients.add(ws);
   console.log(`[WS] Client connected (total: ${wsClients.size})`);
 
+  // Subscriptions are acknowledged but not applied; the mock streams everything
+  ws.on("message", (data) => {
+    try {
+      const msg = JSON.parse(data.toString());
+      if (msg.type === "subscribe" || msg.type === "unsubscribe") {
+        ws.send(JSON.stringify({ event: msg.type === "subscribe" ? "SUBSCRIBED" : "UNSUBSCRIBED", id: msg.id }));
+      } else if (msg.type === "command") {
+        if (!msg.requestId || !msg.commandType) {
+          ws.send(JSON.stringify({ event: "ERROR", id: msg.requestId ?? "", error: "Missing requestId or commandType" }));
+          return;
+        }
+        const existingId = msg.idempotencyKey ? idempotencyIndex.get(msg.idempotencyKey) : undefined;
+        const cmd: StoredCommand = (existingId && commands.get(existingId)) || {
+          commandId: generateId(),
+          idempotencyKey: msg.idempotencyKey ?? generateId(),
+          type: msg.commandType,
+          payload: msg.payload ?? null,
+          status: "QUEUED",
+          result: null,
+          error: null,
+          requestId: msg.requestId,
+        };
+        ws.send(
+          JSON.stringify({
+            event: "COMMAND_ACK",
+            requestId: msg.requestId,
+            commandId: cmd.commandId,
+            status: cmd.status,
+            result: cmd.result,
+            error: cmd.error,
+          }),
+        );
+        if (!existingId) {
+          commands.set(cmd.commandId, cmd);
+          idempotencyIndex.set(cmd.idempotencyKey, cmd.commandId);
+          simulateExecution(cmd);
+        }
+      }
+    } catch {
+      ws.send(JSON.stringify({ event: "ERROR", id: "", error: "Invalid JSON" }));
+    }
+  });
+
   ws.on("close", () => {
     wsClients.delete(ws);
     console.log(`[WS] Client disconnected (total: ${wsClients.size})`);
@@ -225,5 +381,7 @@ server.listen(PORT, () => {
   console.log(`  Token: ${TOKEN}`);
   console.log(`  Capabilities: GET http://localhost:${PORT}/control/v1/capabilities`);
   console.log(`  Commands:     POST http://localhost:${PORT}/control/v1/commands`);
+  console.log(`  Batch:        POST http://localhost:${PORT}/control/v1/commands/batch`);
+  console.log(`  SSE Stream:   http://localhost:${PORT}/control/v1/events?token=${TOKEN}`);
   console.log(`  WS Stream:    ws://localhost:${PORT}/control/v1/stream?token=${TOKEN}`);
 });
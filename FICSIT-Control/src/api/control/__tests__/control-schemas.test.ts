@@ -1,13 +1,19 @@
 import { describe, it, expect } from "vitest";
 import {
   CapabilitiesResponseSchema,
+  CommandAckSchema,
   CommandResponseSchema,
   CommandStatusEventSchema,
+  CommandBatchEventSchema,
+  CommandBatchResponseSchema,
+  ResyncEventSchema,
   ResetFusePayloadSchema,
   SetOverclockPayloadSchema,
   ToggleBuildingPayloadSchema,
   SetRecipePayloadSchema,
   ToggleGeneratorGroupPayloadSchema,
+  SubscriptionFilterSchema,
+  SubscriptionReplySchema,
 } from "../control-schemas";
 
 describe("CapabilitiesResponseSchema", () => {
@@ -147,6 +153,41 @@ describe("CommandStatusEventSchema", () => {
   });
 });
 
+describe("CommandBatchResponseSchema", () => {
+  it("parses per-item command responses", () => {
+    const input = {
+      commands: [
+        { commandId: "cmd-1", status: "QUEUED" },
+        { commandId: "", status: "FAILED", error: "Unknown command type: NOPE" },
+      ],
+    };
+    const result = CommandBatchResponseSchema.parse(input);
+    expect(result.commands).toHaveLength(2);
+    expect(result.commands[0].result).toBeNull();
+    expect(result.commands[1].error).toBe("Unknown command type: NOPE");
+  });
+});
+
+describe("CommandBatchEventSchema", () => {
+  it("parses a batch of status events", () => {
+    const input = {
+      event: "COMMAND_BATCH",
+      commands: [
+        { event: "COMMAND_STATUS", commandId: "cmd-1", status: "SUCCEEDED" },
+        { event: "COMMAND_STATUS", commandId: "cmd-2", status: "FAILED", error: "Machine not found" },
+      ],
+    };
+    const result = CommandBatchEventSchema.parse(input);
+    expect(result.commands).toHaveLength(2);
+    expect(result.commands[1].status).toBe("FAILED");
+  });
+
+  it("rejects a single status event", () => {
+    const input = { event: "COMMAND_STATUS", commandId: "cmd-1", status: "SUCCEEDED" };
+    expect(CommandBatchEventSchema.safeParse(input).success).toBe(false);
+  });
+});
+
 describe("payload schemas", () => {
   it("validates ResetFusePayload", () => {
     const result = ResetFusePayloadSchema.parse({ circuitId: 1 });
@@ -191,3 +232,71 @@ describe("payload schemas", () => {
     expect(result.success).toBe(false);
   });
 });
+
+describe("Subscription schemas", () => {
+  it("accepts a partial filter", () => {
+    const result = SubscriptionFilterSchema.parse({ buildingIds: ["smelter-3"], commandTypes: ["TOGGLE_BUILDING"] });
+    expect(result.buildingIds).toEqual(["smelter-3"]);
+    expect(result.commandIds).toBeUndefined();
+  });
+
+  it("rejects unknown command types in a filter", () => {
+    const result = SubscriptionFilterSchema.safeParse({ commandTypes: ["SELF_DESTRUCT"] });
+    expect(result.success).toBe(false);
+  });
+
+  it("parses an error reply", () => {
+    const result = SubscriptionReplySchema.parse({ event: "ERROR", id: "panel", error: "Unknown subscription" });
+    expect(result.error).toBe("Unknown subscription");
+  });
+});
+
+describe("Event sequence numbers", () => {
+  it("keeps the seq of a batch event", () => {
+    const result = CommandBatchEventSchema.parse({
+      event: "COMMAND_BATCH",
+      seq: 42,
+      commands: [{ event: "COMMAND_STATUS", commandId: "cmd-1", status: "SUCCEEDED" }],
+    });
+    expect(result.seq).toBe(42);
+    expect(result.commands[0].seq).toBeUndefined();
+  });
+
+  it("parses a resync marker", () => {
+    const result = ResyncEventSchema.parse({ event: "RESYNC", since: 10, seq: 2048 });
+    expect(result.seq).toBe(2048);
+  });
+
+  it("rejects a negative seq", () => {
+    const result = CommandStatusEventSchema.safeParse({
+      event: "COMMAND_STATUS",
+      seq: -1,
+      commandId: "cmd-1",
+      status: "QUEUED",
+    });
+    expect(result.success).toBe(false);
+  });
+});
+
+describe("Stream command schemas", () => {
+  it("parses an acknowledgement with its requestId", () => {
+    const result = CommandAckSchema.parse({
+      event: "COMMAND_ACK",
+      requestId: "r1",
+      commandId: "cmd-1",
+      status: "QUEUED",
+    });
+    expect(result.requestId).toBe("r1");
+    expect(result.result).toBeNull();
+  });
+
+  it("keeps the requestId on a status event", () => {
+    const result = CommandStatusEventSchema.parse({
+      event: "COMMAND_STATUS",
+      commandId: "cmd-1",
+      requestId: "r1",
+      status: "RUNNING",
+    });
+    expect(result.requestId).toBe("r1");
+  });
+});
@@ -1,14 +1,43 @@
 import type { z } from "zod";
-import type { CapabilitiesResponse, CommandResponse, CommandStatusEvent, CommandType } from "../../types/control";
-import { CapabilitiesResponseSchema, CommandResponseSchema, CommandStatusEventSchema } from "./control-schemas";
+import type {
+  CapabilitiesResponse,
+  CommandBatchResponse,
+  CommandResponse,
+  CommandStatusEvent,
+  CommandType,
+  SubscriptionFilter,
+} from "../../types/control";
+import {
+  CapabilitiesResponseSchema,
+  CommandAckSchema,
+  CommandBatchEventSchema,
+  CommandBatchResponseSchema,
+  CommandResponseSchema,
+  CommandStatusEventSchema,
+  ResyncEventSchema,
+  SubscriptionReplySchema,
+} from "./control-schemas";
 
 export type ControlEventHandler = (event: CommandStatusEvent) => void;
+export type ControlResyncHandler = () => void;
+
+interface PendingStreamCommand {
+  resolve: (response: CommandResponse) => void;
+  reject: (err: Error) => void;
+  timeoutId: ReturnType<typeof setTimeout>;
+}
 
 export class ControlClient {
   private ws: WebSocket | null = null;
   private baseUrl: string;
   private token: string;
   private handlers: Set<ControlEventHandler> = new Set();
+  private resyncHandlers: Set<ControlResyncHandler> = new Set();
+  /** Newest event seen; sent as ?since= on reconnect so missed events are replayed */
+  private lastSeq: number | null = null;
+  private subscriptions: Map<string, SubscriptionFilter> = new Map();
+  /** Stream commands awaiting their COMMAND_ACK, by requestId */
+  private pendingCommands: Map<string, PendingStreamCommand> = new Map();
   private reconnectTimer: ReturnType<typeof setTimeout> | null = null;
   private reconnectAttempts = 0;
   private maxReconnectAttempts = 10;
@@ -41,15 +70,37 @@ export class ControlClient {
     return this.postEndpoint("/control/v1/commands", request, CommandResponseSchema);
   }
 
+  /** Submit many commands at once; the mod applies them in a single game tick */
+  async submitBatch(
+    commands: { idempotencyKey: string; type: CommandType; payload: unknown }[],
+  ): Promise<CommandBatchResponse> {
+    return this.postEndpoint("/control/v1/commands/batch", { commands }, CommandBatchResponseSchema);
+  }
+
   async getCommandStatus(commandId: string): Promise<CommandResponse> {
     return this.getEndpoint(`/control/v1/commands/${commandId}`, CommandResponseSchema, true);
   }
 
+  /** Long-poll until the command succeeds or fails, or waitSeconds pass (server caps at 30) */
+  async waitForCommand(commandId: string, waitSeconds = 25): Promise<CommandResponse> {
+    return this.getEndpoint(
+      `/control/v1/commands/${commandId}?wait=${waitSeconds}`,
+      CommandResponseSchema,
+      true,
+      (waitSeconds + 8) * 1000,
+    );
+  }
+
   // --- Private REST helpers ---
 
-  private async getEndpoint<T>(path: string, schema: z.ZodType<T>, auth: boolean): Promise<T> {
+  private async getEndpoint<T>(
+    path: string,
+    schema: z.ZodType<T>,
+    auth: boolean,
+    timeoutMs = 8000,
+  ): Promise<T> {
     const controller = new AbortController();
-    const timeoutId = setTimeout(() => controller.abort(), 8000);
+    const timeoutId = setTimeout(() => controller.abort(), timeoutMs);
     try {
       const headers: Record<string, string> = {};
       if (auth) headers["Authorization"] = `Bearer ${this.token}`;
@@ -67,7 +118,7 @@ export class ControlClient {
       return schema.parse(json);
     } catch (err) {
       if (err instanceof DOMException && err.name === "AbortError") {
-        throw new Error(`Control request to ${path} timed out after 8s`);
+        throw new Error(`Control request to ${path} timed out after ${timeoutMs / 1000}s`);
       }
       throw err;
     } finally {
@@ -117,11 +168,18 @@ export class ControlClient {
   private createWebSocket(): Promise<void> {
     return new Promise((resolve, reject) => {
       try {
-        const url = `${this.wsUrl}/control/v1/stream?token=${encodeURIComponent(this.token)}`;
+        let url = `${this.wsUrl}/control/v1/stream?token=${encodeURIComponent(this.token)}`;
+        if (this.lastSeq !== null) {
+          url += `&since=${this.lastSeq}`;
+        }
         this.ws = new WebSocket(url);
 
         this.ws.onopen = () => {
           this.reconnectAttempts = 0;
+          // The server forgets subscriptions with the socket; restore them
+          for (const [id, filter] of this.subscriptions) {
+            this.sendSubscription({ type: "subscribe", id, filter });
+          }
           resolve();
         };
 
@@ -136,6 +194,7 @@ export class ControlClient {
 
         this.ws.onclose = () => {
           this.ws = null;
+          this.rejectPendingCommands("Control stream closed");
           if (this.shouldReconnect) {
             this.scheduleReconnect();
           }
@@ -152,12 +211,124 @@ export class ControlClient {
     });
   }
 
+  /**
+   * Only receive events matching filter (server-side). Calling again with the
+   * same id replaces the filter. Without any subscription every event arrives.
+   */
+  subscribe(id: string, filter: SubscriptionFilter) {
+    this.subscriptions.set(id, filter);
+    this.sendSubscription({ type: "subscribe", id, filter });
+  }
+
+  unsubscribe(id: string) {
+    if (this.subscriptions.delete(id)) {
+      this.sendSubscription({ type: "unsubscribe", id });
+    }
+  }
+
+  /**
+   * Submit a command on the open stream instead of over HTTP. Resolves with
+   * the acknowledgement; the command's status events carry the same requestId.
+   */
+  sendCommand(
+    request: { idempotencyKey: string; type: CommandType; payload: unknown },
+    timeoutMs = 8000,
+  ): Promise<CommandResponse> {
+    const ws = this.ws;
+    if (ws?.readyState !== WebSocket.OPEN) {
+      return Promise.reject(new Error("Control stream is not connected"));
+    }
+
+    const requestId = crypto.randomUUID();
+    return new Promise((resolve, reject) => {
+      const timeoutId = setTimeout(() => {
+        this.pendingCommands.delete(requestId);
+        reject(new Error(`Stream command ${request.type} timed out after ${timeoutMs / 1000}s`));
+      }, timeoutMs);
+      this.pendingCommands.set(requestId, { resolve, reject, timeoutId });
+
+      ws.send(
+        JSON.stringify({
+          type: "command",
+          requestId,
+          commandType: request.type,
+          payload: request.payload,
+          idempotencyKey: request.idempotencyKey,
+        }),
+      );
+    });
+  }
+
+  private settlePendingCommand(requestId: string): PendingStreamCommand | undefined {
+    const pending = this.pendingCommands.get(requestId);
+    if (pending) {
+      clearTimeout(pending.timeoutId);
+      this.pendingCommands.delete(requestId);
+    }
+    return pending;
+  }
+
+  private rejectPendingCommands(reason: string) {
+    for (const requestId of [...this.pendingCommands.keys()]) {
+      this.settlePendingCommand(requestId)?.reject(new Error(reason));
+    }
+  }
+
+  private sendSubscription(message: { type: "subscribe" | "unsubscribe"; id: string; filter?: SubscriptionFilter }) {
+    if (this.ws?.readyState === WebSocket.OPEN) {
+      this.ws.send(JSON.stringify(message));
+    }
+  }
+
   private handleMessage(data: unknown) {
     const parsed = CommandStatusEventSchema.safeParse(data);
     if (parsed.success) {
-      for (const handler of this.handlers) {
-        handler(parsed.data);
+      this.lastSeq = parsed.data.seq ?? this.lastSeq;
+      this.emit(parsed.data);
+      return;
+    }
+
+    // A batch arrives as one message; deliver its commands individually
+    const batch = CommandBatchEventSchema.safeParse(data);
+    if (batch.success) {
+      this.lastSeq = batch.data.seq ?? this.lastSeq;
+      for (const event of batch.data.commands) {
+        this.emit(event);
+      }
+      return;
+    }
+
+    // Too much was missed to replay; listeners should refetch command state
+    const resync = ResyncEventSchema.safeParse(data);
+    if (resync.success) {
+      this.lastSeq = resync.data.seq;
+      for (const handler of this.resyncHandlers) {
+        handler();
       }
+      return;
+    }
+
+    const ack = CommandAckSchema.safeParse(data);
+    if (ack.success) {
+      const { requestId, commandId, status, result, error } = ack.data;
+      this.settlePendingCommand(requestId)?.resolve({ commandId, status, result, error });
+      return;
+    }
+
+    const reply = SubscriptionReplySchema.safeParse(data);
+    if (reply.success && reply.data.event === "ERROR") {
+      const pending = this.settlePendingCommand(reply.data.id);
+      if (pending) {
+        pending.reject(new Error(`Stream command rejected: ${reply.data.error}`));
+        return;
+      }
+      console.warn(`[Control] Stream subscription ${reply.data.id} rejected: ${reply.data.error}`);
+    }
+  }
+
+  private emit(event: CommandStatusEvent) {
+    for (const handler of this.handlers) {
+      handler(event);
     }
   }
 
@@ -180,6 +351,12 @@ export class ControlClient {
     return () => this.handlers.delete(handler);
   }
 
+  /** Called when the stream could not replay what was missed while disconnected */
+  onResync(handler: ControlResyncHandler): () => void {
+    this.resyncHandlers.add(handler);
+    return () => this.resyncHandlers.delete(handler);
+  }
+
   disconnect() {
     this.shouldReconnect = false;
     if (this.reconnectTimer) {
@@ -190,7 +367,11 @@ export class ControlClient {
       this.ws.close();
       this.ws = null;
     }
+    this.rejectPendingCommands("Control stream disconnected");
     this.handlers.clear();
+    this.resyncHandlers.clear();
+    this.subscriptions.clear();
+    this.lastSeq = null;
   }
 
   get isConnected(): boolean {
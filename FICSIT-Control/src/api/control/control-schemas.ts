@@ -15,6 +15,8 @@ export const CapabilitiesResponseSchema = z.object({
   features: ControlFeatureMapSchema,
   limits: z.object({
     commandsPerSecond: z.number().default(5),
+    batchCommandsPerSecond: z.number().optional(),
+    maxBatchSize: z.number().optional(),
   }),
 });
 
@@ -84,12 +86,64 @@ export const CommandResponseSchema = z.object({
   error: z.string().nullable().default(null),
 });
 
+export const CommandBatchRequestSchema = z.object({
+  commands: z.array(CommandRequestSchema).min(1),
+});
+
+export const CommandBatchResponseSchema = z.object({
+  commands: z.array(CommandResponseSchema),
+});
+
 // -- WebSocket events --
 
+/** Stream position of a top-level event; reconnect with ?since=<seq> to resume after it */
+const EventSeqSchema = z.number().int().nonnegative();
+
 export const CommandStatusEventSchema = z.object({
   event: z.literal("COMMAND_STATUS"),
+  seq: EventSeqSchema.optional(),
   commandId: z.string(),
+  /** Set when the command was submitted over the stream */
+  requestId: z.string().optional(),
   status: CommandStatusSchema,
   result: z.unknown().nullable().default(null),
   error: z.string().nullable().default(null),
 });
+
+/** One event summarising every command of a batch, in submission order */
+export const CommandBatchEventSchema = z.object({
+  event: z.literal("COMMAND_BATCH"),
+  seq: EventSeqSchema.optional(),
+  commands: z.array(CommandStatusEventSchema),
+});
+
+/** Events after `since` were no longer retained: refetch state, then continue from `seq` */
+export const ResyncEventSchema = z.object({
+  event: z.literal("RESYNC"),
+  since: EventSeqSchema,
+  seq: EventSeqSchema,
+});
+
+/** Reply to a command submitted over the stream; commandId is empty if it was rejected */
+export const CommandAckSchema = CommandResponseSchema.extend({
+  event: z.literal("COMMAND_ACK"),
+  requestId: z.string(),
+});
+
+// -- WebSocket subscriptions --
+
+/** Server-side event filter; an omitted or empty list matches anything */
+export const SubscriptionFilterSchema = z.object({
+  commandTypes: z.array(CommandTypeSchema).optional(),
+  commandIds: z.array(z.string().min(1)).optional(),
+  /** Token fingerprints: first 16 hex digits of SHA-1(token), lowercase */
+  issuers: z.array(z.string().min(1)).optional(),
+  buildingIds: z.array(z.string().min(1)).optional(),
+});
+
+/** Reply to a subscribe or unsubscribe message */
+export const SubscriptionReplySchema = z.object({
+  event: z.enum(["SUBSCRIBED", "UNSUBSCRIBED", "ERROR"]),
+  id: z.string(),
+  error: z.string().optional(),
+});
@@ -6,6 +6,8 @@ import type {
   CommandStatusSchema,
   CommandResponseSchema,
   CommandStatusEventSchema,
+  CommandBatchResponseSchema,
+  SubscriptionFilterSchema,
 } from "../api/control/control-schemas";
 
 export type ControlFeatureMap = z.infer<typeof ControlFeatureMapSchema>;
@@ -14,6 +16,8 @@ export type CommandType = z.infer<typeof CommandTypeSchema>;
 export type CommandStatus = z.infer<typeof CommandStatusSchema>;
 export type CommandResponse = z.infer<typeof CommandResponseSchema>;
 export type CommandStatusEvent = z.infer<typeof CommandStatusEventSchema>;
+export type CommandBatchResponse = z.infer<typeof CommandBatchResponseSchema>;
+export type SubscriptionFilter = z.infer<typeof SubscriptionFilterSchema>;
 
 export interface CommandLogEntry {
   commandId: string;